@@ -157,6 +157,20 @@ public:
 
 	void extend(size_t capacity = 0);
 
+	// replaces the content with a copy of the elements of other
+	void copy_from(const managed_array& other)
+	{
+		if constexpr (dynamic) {
+			resize(other.size());
+		} else {
+			inkAssert(other.size() <= initialCapacity, "capacity of non dynamic array is to small");
+			_size = other.size();
+		}
+		for (size_t i = 0; i < _size; ++i) {
+			data()[i] = other.data()[i];
+		}
+	}
+
 	bool can_be_migrated() const { return true; }
 
 	size_t snap(unsigned char* data, const snapper& snapper) const
@@ -164,12 +178,12 @@ public:
 		inkAssert(! is_pointer<T>{}(), "here is a special case oversight");
 		unsigned char* ptr          = data;
 		bool           should_write = data != nullptr;
-		ptr                         = snap_write(ptr, _size, should_write);
+		ptr                         = snap_write(ptr, _size, should_write, snapper);
 		for (const T& e : *this) {
 			if constexpr (is_base_of<snapshot_interface, T>::value) {
 				ptr += e.snap(data == nullptr ? nullptr : ptr, snapper);
 			} else {
-				ptr = snap_write(ptr, e, should_write);
+				ptr = snap_write(ptr, e, should_write, snapper);
 			}
 		}
 		return static_cast<size_t>(ptr - data);
@@ -178,7 +192,7 @@ public:
 	const unsigned char* snap_load(const unsigned char* ptr, const loader& loader)
 	{
 		decltype(_size) size;
-		ptr = snap_read(ptr, size);
+		ptr = snap_read(ptr, size, loader);
 		if constexpr (dynamic) {
 			resize(size);
 		} else {
@@ -189,7 +203,7 @@ public:
 			if constexpr (is_base_of<snapshot_interface, T>::value) {
 				ptr = e.snap_load(ptr, loader);
 			} else {
-				ptr = snap_read(ptr, e);
+				ptr = snap_read(ptr, e, loader);
 			}
 		}
 		return ptr;
@@ -241,6 +255,13 @@ public:
 
 	size_t last_size() const { return _last_size; }
 
+	// replaces the content and the save point with the ones of other
+	void copy_from(const managed_restorable_array& other)
+	{
+		base::copy_from(other);
+		_last_size = other._last_size;
+	}
+
 	bool can_be_migrated() const { return ! is_saved(); }
 
 	size_t snap(unsigned char* data, const snapshot_interface::snapper& snapper) const
@@ -248,14 +269,14 @@ public:
 		unsigned char* ptr          = data;
 		bool           should_write = data != nullptr;
 		ptr += base::snap(ptr, snapper);
-		ptr = base::snap_write(ptr, _last_size, should_write);
+		ptr = base::snap_write(ptr, _last_size, should_write, snapper);
 		return static_cast<size_t>(ptr - data);
 	}
 
 	const unsigned char* snap_load(const unsigned char* ptr, const snapshot_interface::loader& loader)
 	{
 		ptr = base::snap_load(ptr, loader);
-		ptr = base::snap_read(ptr, _last_size);
+		ptr = base::snap_read(ptr, _last_size, loader);
 		return ptr;
 	}
 
@@ -291,27 +312,43 @@ void managed_array<T, dynamic, initialCapacity, simple>::extend(size_t capacity)
 	_capacity     = new_capacity;
 }
 
+/** Array which can save its state and later restore or forget the changes made since.
+ *
+ * Values are written in place. While saved, the first write to an index puts its previous value in
+ * an undo journal, so restore() and forget() only touch the indices changed since the save.
+ */
 template<typename T>
 class basic_restorable_array : public snapshot_interface
 {
 public:
-	basic_restorable_array(T* array, size_t capacity, T nullValue)
+	// value of an index before its first change since the save
+	struct journal_entry {
+		size_t index;
+		T      value;
+	};
+
+	// number of words needed to mark capacity indices as changed
+	static constexpr size_t dirty_words(size_t capacity) { return (capacity + 31) / 32; }
+
+	basic_restorable_array(
+	    T* array, uint32_t* dirty, size_t capacity, journal_entry* journal, size_t journal_capacity,
+	    T nullValue
+	)
 	    : _saved(false)
 	    , _array(array)
-	    , _temp(array + capacity / 2)
-	    , _capacity(capacity / 2)
+	    , _dirty(dirty)
+	    , _capacity(capacity)
+	    , _journal(journal)
+	    , _journal_capacity(journal_capacity)
 	    , _null(nullValue)
 	{
-		inkAssert(
-		    capacity % 2 == 0,
-		    "basic_restorable_array requires a datablock of even length to split into two arrays"
-		);
-
-		// zero out main array and put 'nulls' in the clear_temp()
+		// zero out main array and the change marks
 		inkZeroMemory(_array, _capacity * sizeof(T));
-		clear_temp();
+		inkZeroMemory(_dirty, dirty_words(_capacity) * sizeof(uint32_t));
 	}
 
+	virtual ~basic_restorable_array() {}
+
 	// not copyable
 	basic_restorable_array(const basic_restorable_array<T>&)               = delete;
 	basic_restorable_array<T>& operator=(const basic_restorable_array<T>&) = delete;
@@ -345,45 +382,90 @@ public:
 	// Resets all values and clears any save points
 	void clear(const T& value);
 
+	// replaces the values, the save point and the journal with the ones of other
+	void copy_from(const basic_restorable_array& other);
+
 	// snapshot interface
 	virtual bool                 can_be_migrated() const;
 	virtual size_t               snap(unsigned char* data, const snapper&) const;
 	virtual const unsigned char* snap_load(const unsigned char* data, const loader&);
 
+	// snap values passed through map, for values stored different than they are kept in memory
+	template<typename F>
+	size_t snap(unsigned char* data, const snapper&, F map) const;
+	// pass all values read by snap_load through map
+	template<typename F>
+	void map_loaded(F map);
+
+	// if the index holds a default constructed T after passing it through map and was not changed
+	// since the save, the compact snapshot format skips these entries
+	template<typename F>
+	bool is_default(size_t index, F map) const
+	{
+		return ! is_dirty(index) && map(_array[index]) == T{};
+	}
+
 protected:
 	inline T* buffer() { return _array; }
 
-	void set_new_buffer(T* buffer, size_t capacity)
+	// dirty must hold dirty_words(capacity) words, the content of both is kept by the caller
+	void set_new_buffer(T* buffer, uint32_t* dirty, size_t capacity)
 	{
 		_array    = buffer;
-		_temp     = buffer + capacity / 2;
-		_capacity = capacity / 2;
+		_dirty    = dirty;
+		_capacity = capacity;
+	}
+
+	inline journal_entry* journal() { return _journal; }
+
+	inline size_t journal_size() const { return _journal_size; }
+
+	// the entries are kept by the caller
+	void set_new_journal(journal_entry* journal, size_t capacity)
+	{
+		_journal          = journal;
+		_journal_capacity = capacity;
 	}
 
+	// called if the journal is full, must provide a larger one with set_new_journal(). Each index is
+	// journaled at most once, so a journal with capacity() entries never overflows.
+	virtual void grow_journal() { inkFail("Journal of a restorable array is full"); }
+
 private:
 	inline void check_index(size_t index) const
 	{
 		inkAssert(index < capacity(), "Index out of range!");
 	}
 
-	void clear_temp();
+	inline bool is_dirty(size_t index) const { return _dirty[index / 32] & (1u << (index % 32)); }
+
+	// keeps the current value of index in the journal
+	void record(size_t index);
+	// value of index at the time of the save
+	const T& saved_value(size_t index) const;
+	// drops all journal entries
+	void clear_journal();
 
 private:
 	bool _saved;
 
-	// real values live here
+	// current values
 	T* _array;
 
-	// we store values here when we're in safe mode
-	//  they're copied on a call to forget()
-	T* _temp;
+	// one bit per index, set if the index is in the journal
+	uint32_t* _dirty;
 
-	// size of both _array and _temp
+	// size of _array
 	size_t _capacity;
 	// if loaded with snap_load, this value was the original size, the current capacity might be
 	// higher
 	size_t _loaded_capacity = static_cast<size_t>(~0);
 
+	// undo journal of the changes since the save
+	journal_entry* _journal;
+	size_t         _journal_size = 0;
+	size_t         _journal_capacity;
+
 	// null
 	const T _null;
 };
@@ -394,26 +476,17 @@ inline void basic_restorable_array<T>::set(size_t index, const T& value)
 	check_index(index);
 	inkAssert(value != _null, "Can not add a value considered a 'null' to a restorable_array");
 
-	// If we're saved, store in second half of the array
-	if (_saved) {
-		_temp[index] = value;
-	} else {
-		// Otherwise, store in the main array
-		_array[index] = value;
+	// the first change since the save keeps the old value to restore it later
+	if (_saved && ! is_dirty(index)) {
+		record(index);
 	}
+	_array[index] = value;
 }
 
 template<typename T>
 inline const T& basic_restorable_array<T>::get(size_t index) const
 {
 	check_index(index);
-
-	// If we're in safe mode, and we have a value at that index, return that instead
-	if (_saved && _temp[index] != _null) {
-		return _temp[index];
-	}
-
-	// Otherwise, fall back on the real array
 	return _array[index];
 }
 
@@ -423,7 +496,7 @@ inline const T& basic_restorable_array<T>::get_old(size_t index) const
 	check_index(index);
 	inkAssert(_saved, "Use old only on saved arrays.");
 
-	return _array[index];
+	return saved_value(index);
 }
 
 template<typename T>
@@ -436,7 +509,10 @@ inline void basic_restorable_array<T>::save()
 template<typename T>
 inline void basic_restorable_array<T>::restore()
 {
-	clear_temp();
+	for (size_t i = 0; i < _journal_size; ++i) {
+		_array[_journal[i].index] = _journal[i].value;
+	}
+	clear_journal();
 
 	// Clear saved flag
 	_saved = false;
@@ -445,34 +521,48 @@ inline void basic_restorable_array<T>::restore()
 template<typename T>
 inline void basic_restorable_array<T>::forget()
 {
-	// Run through the _temp array
-	for (size_t i = 0; i < _capacity; i++) {
-		// Copy if there are values
-		if (_temp[i] != _null) {
-			_array[i] = _temp[i];
-		}
+	// the values are already in place
+	clear_journal();
+}
 
-		// Clear
-		_temp[i] = _null;
+template<typename T>
+inline void basic_restorable_array<T>::record(size_t index)
+{
+	if (_journal_size == _journal_capacity) {
+		grow_journal();
 	}
+	_journal[_journal_size++] = {index, _array[index]};
+	_dirty[index / 32] |= 1u << (index % 32);
 }
 
 template<typename T>
-inline void basic_restorable_array<T>::clear_temp()
+inline const T& basic_restorable_array<T>::saved_value(size_t index) const
 {
-	// Run through the _temp array
-	for (size_t i = 0; i < _capacity; i++) {
-		// Clear
-		_temp[i] = _null;
+	if (is_dirty(index)) {
+		for (size_t i = 0; i < _journal_size; ++i) {
+			if (_journal[i].index == index) {
+				return _journal[i].value;
+			}
+		}
 	}
+	return _array[index];
+}
+
+template<typename T>
+inline void basic_restorable_array<T>::clear_journal()
+{
+	for (size_t i = 0; i < _journal_size; ++i) {
+		_dirty[_journal[i].index / 32] &= ~(1u << (_journal[i].index % 32));
+	}
+	_journal_size = 0;
 }
 
 template<typename T>
 inline void basic_restorable_array<T>::clear(const T& value)
 {
 	_saved = false;
+	clear_journal();
 	for (size_t i = 0; i < _capacity; i++) {
-		_temp[i]  = _null;
 		_array[i] = value;
 	}
 }
@@ -480,15 +570,19 @@ inline void basic_restorable_array<T>::clear(const T& value)
 template<typename T, size_t SIZE>
 class fixed_restorable_array : public basic_restorable_array<T>
 {
+	using base = basic_restorable_array<T>;
+
 public:
 	fixed_restorable_array(const T& initial, const T& nullValue)
-	    : basic_restorable_array<T>(_buffer, SIZE * 2, nullValue)
+	    : base(_buffer, _dirty, SIZE, _journal, SIZE, nullValue)
 	{
-		basic_restorable_array<T>::clear(initial);
+		base::clear(initial);
 	}
 
 private:
-	T _buffer[SIZE * 2];
+	T                            _buffer[SIZE];
+	uint32_t                     _dirty[base::dirty_words(SIZE)];
+	typename base::journal_entry _journal[SIZE];
 };
 
 template<typename T>
@@ -498,57 +592,100 @@ class allocated_restorable_array : public basic_restorable_array<T>
 
 public:
 	allocated_restorable_array(const T& initial, const T& nullValue)
-	    : basic_restorable_array<T>(0, 0, nullValue)
+	    : base(nullptr, nullptr, 0, nullptr, 0, nullValue)
 	    , _initialValue{initial}
 	    , _nullValue{nullValue}
 	    , _buffer{nullptr}
+	    , _dirty{nullptr}
+	    , _journal{nullptr}
 	{
 	}
 
 	allocated_restorable_array(size_t capacity, const T& initial, const T& nullValue)
-	    : basic_restorable_array<T>(new T[capacity * 2], capacity * 2, nullValue)
-	    , _initialValue{initial}
-	    , _nullValue{nullValue}
+	    : allocated_restorable_array(initial, nullValue)
 	{
-		_buffer = this->buffer();
-		this->clear(_initialValue);
+		resize(capacity);
 	}
 
 	void resize(size_t n)
 	{
-		size_t new_capacity = 2 * n;
-		T*     new_buffer   = new T[new_capacity];
+		T*        new_buffer = new T[n];
+		uint32_t* new_dirty  = new uint32_t[base::dirty_words(n)]{};
 		if (_buffer) {
 			for (size_t i = 0; i < base::capacity(); ++i) {
-				new_buffer[i]     = _buffer[i];
-				// copy temp
-				new_buffer[i + n] = _buffer[i + base::capacity()];
+				new_buffer[i] = _buffer[i];
+			}
+			for (size_t i = 0; i < base::dirty_words(base::capacity()); ++i) {
+				new_dirty[i] = _dirty[i];
 			}
 			delete[] _buffer;
+			delete[] _dirty;
 		}
 		for (size_t i = base::capacity(); i < n; ++i) {
-			new_buffer[i]     = _initialValue;
-			new_buffer[i + n] = _nullValue;
+			new_buffer[i] = _initialValue;
 		}
 
 		_buffer = new_buffer;
-		this->set_new_buffer(_buffer, new_capacity);
+		_dirty  = new_dirty;
+		this->set_new_buffer(_buffer, _dirty, n);
 	}
 
 	virtual ~allocated_restorable_array()
 	{
-		if (_buffer) {
-			delete[] _buffer;
-			_buffer = nullptr;
+		delete[] _buffer;
+		delete[] _dirty;
+		delete[] _journal;
+		_buffer  = nullptr;
+		_dirty   = nullptr;
+		_journal = nullptr;
+	}
+
+protected:
+	void grow_journal() override
+	{
+		using entry         = typename base::journal_entry;
+		size_t new_capacity = _journal_capacity == 0 ? 16 : _journal_capacity * 2;
+		entry* new_journal  = new entry[new_capacity];
+		for (size_t i = 0; i < base::journal_size(); ++i) {
+			new_journal[i] = _journal[i];
 		}
+		delete[] _journal;
+		_journal          = new_journal;
+		_journal_capacity = new_capacity;
+		this->set_new_journal(_journal, _journal_capacity);
 	}
 
 private:
-	T  _initialValue;
-	T  _nullValue;
-	T* _buffer;
+	T                             _initialValue;
+	T                             _nullValue;
+	T*                            _buffer;
+	uint32_t*                     _dirty;
+	typename base::journal_entry* _journal;
+	size_t                        _journal_capacity = 0;
 };
 
+template<typename T>
+inline void basic_restorable_array<T>::copy_from(const basic_restorable_array& other)
+{
+	inkAssert(other._null == _null, "null value is different to the copied array!");
+	if (_capacity < other._capacity) {
+		static_cast<allocated_restorable_array<T>&>(*this).resize(other._capacity);
+	}
+	clear_journal();
+	for (size_t i = 0; i < other._capacity; ++i) {
+		_array[i] = other._array[i];
+	}
+	for (size_t i = 0; i < other._journal_size; ++i) {
+		if (_journal_size == _journal_capacity) {
+			grow_journal();
+		}
+		const journal_entry& entry = other._journal[i];
+		_journal[_journal_size++]  = entry;
+		_dirty[entry.index / 32] |= 1u << (entry.index % 32);
+	}
+	_saved = other._saved;
+}
+
 template<typename T>
 inline bool basic_restorable_array<T>::can_be_migrated() const
 {
@@ -556,27 +693,68 @@ inline bool basic_restorable_array<T>::can_be_migrated() const
 }
 
 template<typename T>
-inline size_t basic_restorable_array<T>::snap(unsigned char* data, const snapper&) const
+inline size_t basic_restorable_array<T>::snap(unsigned char* data, const snapper& snapper) const
+{
+	return snap(data, snapper, [](const T& value) { return value; });
+}
+
+template<typename T>
+template<typename F>
+inline size_t
+    basic_restorable_array<T>::snap(unsigned char* data, const snapper& snapper, F map) const
 {
 	unsigned char* ptr          = data;
 	bool           should_write = data != nullptr;
 	ptr                         = snap_write(ptr, _saved, should_write);
-	ptr                         = snap_write(ptr, _capacity, should_write);
-	ptr                         = snap_write(ptr, _null, should_write);
+	ptr                         = snap_write(ptr, _capacity, should_write, snapper);
+	ptr                         = snap_write(ptr, _null, should_write, snapper);
+	// each entry is stored as the value at the save, followed by the current value if it changed
+	// since, else _null
+	if (snapper.compact) {
+		// sparse: number of stored entries, then each with the distance to the previous index
+		size_t count = 0;
+		for (size_t i = 0; i < _capacity; ++i) {
+			count += is_default(i, map) ? 0 : 1;
+		}
+		ptr         = snap_write(ptr, count, should_write, snapper);
+		size_t last = 0;
+		for (size_t i = 0; i < _capacity; ++i) {
+			if (is_default(i, map)) {
+				continue;
+			}
+			ptr  = snap_write(ptr, i - last, should_write, snapper);
+			last = i;
+			ptr  = snap_write(ptr, map(saved_value(i)), should_write, snapper);
+			ptr  = snap_write(ptr, is_dirty(i) ? map(_array[i]) : _null, should_write, snapper);
+		}
+		return static_cast<size_t>(ptr - data);
+	}
 	for (size_t i = 0; i < _capacity; ++i) {
-		ptr = snap_write(ptr, _array[i], should_write);
-		ptr = snap_write(ptr, _temp[i], should_write);
+		ptr = snap_write(ptr, map(saved_value(i)), should_write);
+		ptr = snap_write(ptr, is_dirty(i) ? map(_array[i]) : _null, should_write);
 	}
 	return static_cast<size_t>(ptr - data);
 }
 
+template<typename T>
+template<typename F>
+inline void basic_restorable_array<T>::map_loaded(F map)
+{
+	for (size_t i = 0; i < loaded_capacity(); ++i) {
+		_array[i] = map(_array[i]);
+	}
+	for (size_t i = 0; i < _journal_size; ++i) {
+		_journal[i].value = map(_journal[i].value);
+	}
+}
+
 template<typename T>
 inline const unsigned char*
-    basic_restorable_array<T>::snap_load(const unsigned char* data, const loader&)
+    basic_restorable_array<T>::snap_load(const unsigned char* data, const loader& loader)
 {
 	auto ptr = data;
 	ptr      = snap_read(ptr, _saved);
-	ptr      = snap_read(ptr, _loaded_capacity);
+	ptr      = snap_read(ptr, _loaded_capacity, loader);
 	if (buffer() == nullptr) {
 		static_cast<allocated_restorable_array<T>&>(*this).resize(_loaded_capacity);
 	}
@@ -585,11 +763,40 @@ inline const unsigned char*
 	    "New config does not allow for necessary size used by this snapshot!"
 	);
 	T null;
-	ptr = snap_read(ptr, null);
+	ptr = snap_read(ptr, null, loader);
 	inkAssert(null == _null, "null value is different to snapshot!");
+	clear_journal();
+	// the saved value goes in place, a changed value replaces it and keeps it in the journal
+	auto load_entry = [this](size_t index, const T& saved, const T& current) {
+		_array[index] = saved;
+		if (current != _null) {
+			record(index);
+			_array[index] = current;
+		}
+	};
+	T saved, current;
+	if (loader.compact) {
+		for (size_t i = 0; i < _loaded_capacity; ++i) {
+			_array[i] = T{};
+		}
+		size_t count;
+		ptr          = snap_read(ptr, count, loader);
+		size_t index = 0;
+		for (size_t n = 0; n < count; ++n) {
+			size_t distance;
+			ptr = snap_read(ptr, distance, loader);
+			index += distance;
+			inkAssert(index < _loaded_capacity, "Corrupted snapshot, entry out of range.");
+			ptr = snap_read(ptr, saved, loader);
+			ptr = snap_read(ptr, current, loader);
+			load_entry(index, saved, current);
+		}
+		return ptr;
+	}
 	for (size_t i = 0; i < _loaded_capacity; ++i) {
-		ptr = snap_read(ptr, _array[i]);
-		ptr = snap_read(ptr, _temp[i]);
+		ptr = snap_read(ptr, saved);
+		ptr = snap_read(ptr, current);
+		load_entry(i, saved, current);
 	}
 	return ptr;
 }
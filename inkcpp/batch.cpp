@@ -0,0 +1,285 @@
+/* Copyright (c) 2024 Julian Benda
+ *
+ * This file is part of inkCPP which is released under MIT license.
+ * See file LICENSE.txt or go to
+ * https://github.com/JBenda/inkcpp for full license details.
+ */
+#include "batch.h"
+
+#if defined(INK_ENABLE_STL) && defined(INK_ENABLE_THREADS)
+#	include "choice.h"
+#	include "runner.h"
+#	include "runner_impl.h"
+
+#	include <atomic>
+#	include <condition_variable>
+#	include <exception>
+#	include <mutex>
+#	include <thread>
+
+namespace ink::runtime
+{
+const std::string& batch_result::line(size_t index) const
+{
+	inkAssert(index < _num_lines, "Line index %u out of range", static_cast<unsigned>(index));
+	return _lines[index];
+}
+
+size_t batch_result::num_tags(size_t line) const
+{
+	inkAssert(line < _num_lines, "Line index %u out of range", static_cast<unsigned>(line));
+	return _line_tags[line + 1] - _line_tags[line];
+}
+
+const std::string& batch_result::tag(size_t line, size_t index) const
+{
+	inkAssert(index < num_tags(line), "Tag index %u out of range", static_cast<unsigned>(index));
+	return _tags[_line_tags[line] + index];
+}
+
+const std::string& batch_result::choice(size_t index) const
+{
+	inkAssert(index < _num_choices, "Choice index %u out of range", static_cast<unsigned>(index));
+	return _choices[index];
+}
+
+void batch_result::clear()
+{
+	_num_lines = _num_tags = _num_choices = 0;
+	_line_tags.resize(1);
+	_can_continue = false;
+	_suspended    = false;
+}
+
+std::string& batch_result::next(std::vector<std::string>& list, size_t& count)
+{
+	if (count == list.size()) {
+		list.emplace_back();
+	}
+	return list[count++];
+}
+} // namespace ink::runtime
+
+namespace ink::runtime::internal
+{
+class batch_pool
+{
+public:
+	static constexpr size_t no_choice = ~static_cast<size_t>(0);
+
+	struct slot {
+		runner       thread;
+		batch_result result;
+		size_t       lines  = 0;
+		size_t       choice = no_choice;
+	};
+
+	explicit batch_pool(size_t threads)
+	    : _ranges(threads)
+	{
+		for (size_t i = 1; i < threads; ++i) {
+			_workers.emplace_back(&batch_pool::worker_main, this, i);
+		}
+	}
+
+	~batch_pool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_lock);
+			_stop = true;
+		}
+		_start.notify_all();
+		for (std::thread& worker : _workers) {
+			worker.join();
+		}
+	}
+
+	size_t num_threads() const { return _ranges.size(); }
+
+	void run()
+	{
+		// split the slots into one range per worker
+		size_t count   = slots.size();
+		size_t workers = _ranges.size();
+		for (size_t i = 0; i < workers; ++i) {
+			_ranges[i].next.store(count * i / workers, std::memory_order_relaxed);
+			_ranges[i].end = count * (i + 1) / workers;
+		}
+		{
+			std::lock_guard<std::mutex> lock(_lock);
+			++_generation;
+			_busy = _workers.size();
+#	ifdef INK_ENABLE_EXCEPTIONS
+			_error = nullptr;
+#	endif
+		}
+		_start.notify_all();
+		work(0);
+		{
+			std::unique_lock<std::mutex> lock(_lock);
+			_done.wait(lock, [this]() { return _busy == 0; });
+		}
+#	ifdef INK_ENABLE_EXCEPTIONS
+		if (_error) {
+			std::rethrow_exception(_error);
+		}
+#	endif
+	}
+
+	std::vector<slot> slots;
+
+private:
+	// slots [next, end) not yet taken from the range of a worker. Kept on its own cache line, so
+	// workers taking slots from their own range do not disturb each other.
+	struct alignas(64) range {
+		std::atomic<size_t> next{0};
+		size_t              end = 0;
+	};
+
+	void worker_main(size_t worker)
+	{
+		size_t generation = 0;
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(_lock);
+				_start.wait(lock, [&]() { return _stop || _generation != generation; });
+				if (_stop) {
+					return;
+				}
+				generation = _generation;
+			}
+			work(worker);
+			{
+				std::lock_guard<std::mutex> lock(_lock);
+				if (--_busy == 0) {
+					_done.notify_one();
+				}
+			}
+		}
+	}
+
+	// works through the own range first, then steals from the ranges of the following workers
+	void work(size_t worker)
+	{
+		size_t workers = _ranges.size();
+		for (size_t i = 0; i < workers; ++i) {
+			range& r = _ranges[(worker + i) % workers];
+			for (size_t index = r.next.fetch_add(1, std::memory_order_relaxed); index < r.end;
+			     index        = r.next.fetch_add(1, std::memory_order_relaxed)) {
+#	ifdef INK_ENABLE_EXCEPTIONS
+				try {
+					step(slots[index]);
+				}
+				catch (...) {
+					std::lock_guard<std::mutex> lock(_lock);
+					if (! _error) {
+						_error = std::current_exception();
+					}
+				}
+#	else
+				step(slots[index]);
+#	endif
+			}
+		}
+	}
+
+	static void step(slot& s)
+	{
+		batch_result& out    = s.result;
+		runner&       thread = s.thread;
+		out.clear();
+		if (s.choice != no_choice) {
+			size_t choice = s.choice;
+			s.choice      = no_choice;
+			thread->choose(choice);
+		}
+		for (size_t line = 0; thread->can_continue() && (s.lines == 0 || line < s.lines); ++line) {
+			thread->getline(batch_result::next(out._lines, out._num_lines));
+			if (thread->is_suspended()) {
+				// the line is finished by a later run, after the result was delivered
+				--out._num_lines;
+				break;
+			}
+			for (size_t i = 0; i < thread->num_tags(); ++i) {
+				batch_result::next(out._tags, out._num_tags) = thread->get_tag(i);
+			}
+			out._line_tags.push_back(out._num_tags);
+		}
+		out._suspended = thread->is_suspended();
+		if (! out._suspended) {
+			for (const ink::runtime::choice& c : *thread) {
+				batch_result::next(out._choices, out._num_choices) = c.text();
+			}
+		}
+		out._can_continue = thread->can_continue();
+	}
+
+	std::vector<range>       _ranges;
+	std::vector<std::thread> _workers;
+
+	std::mutex              _lock;
+	std::condition_variable _start;
+	std::condition_variable _done;
+	size_t                  _generation = 0;
+	size_t                  _busy       = 0;
+	bool                    _stop       = false;
+#	ifdef INK_ENABLE_EXCEPTIONS
+	std::exception_ptr _error;
+#	endif
+};
+} // namespace ink::runtime::internal
+
+namespace ink::runtime
+{
+batch_executor::batch_executor(size_t threads)
+{
+	if (threads == 0) {
+		threads = std::thread::hardware_concurrency();
+	}
+	_pool = new internal::batch_pool(threads > 0 ? threads : 1);
+}
+
+batch_executor::~batch_executor() { delete _pool; }
+
+size_t batch_executor::add(runner thread)
+{
+	inkAssert(
+	    thread.cast<internal::runner_impl>()->has_own_globals(),
+	    "Runners in a batch need their own globals"
+	);
+	_pool->slots.emplace_back();
+	_pool->slots.back().thread = thread;
+	return _pool->slots.size() - 1;
+}
+
+size_t batch_executor::size() const { return _pool->slots.size(); }
+
+size_t batch_executor::num_threads() const { return _pool->num_threads(); }
+
+runner& batch_executor::get(size_t slot)
+{
+	inkAssert(slot < size(), "Batch slot %u out of range", static_cast<unsigned>(slot));
+	return _pool->slots[slot].thread;
+}
+
+void batch_executor::choose(size_t slot, size_t index)
+{
+	inkAssert(slot < size(), "Batch slot %u out of range", static_cast<unsigned>(slot));
+	_pool->slots[slot].choice = index;
+}
+
+void batch_executor::continue_lines(size_t slot, size_t lines)
+{
+	inkAssert(slot < size(), "Batch slot %u out of range", static_cast<unsigned>(slot));
+	_pool->slots[slot].lines = lines;
+}
+
+void batch_executor::run() { _pool->run(); }
+
+const batch_result& batch_executor::result(size_t slot) const
+{
+	inkAssert(slot < size(), "Batch slot %u out of range", static_cast<unsigned>(slot));
+	return _pool->slots[slot].result;
+}
+} // namespace ink::runtime
+#endif
@@ -9,12 +9,14 @@
 
 namespace ink::runtime::internal
 {
-unsigned char*
-    snap_base(unsigned char* ptr, bool write, size_t pos, size_t jump, size_t save, size_t& max)
+unsigned char* snap_base(
+    unsigned char* ptr, bool write, const snapshot_interface::snapper& snapper, size_t pos,
+    size_t jump, size_t save, size_t& max
+)
 {
-	ptr = snapshot_interface::snap_write(ptr, pos, write);
-	ptr = snapshot_interface::snap_write(ptr, jump, write);
-	ptr = snapshot_interface::snap_write(ptr, save, write);
+	ptr = snapshot_interface::snap_write(ptr, pos, write, snapper);
+	ptr = snapshot_interface::snap_write(ptr, jump, write, snapper);
+	ptr = snapshot_interface::snap_write(ptr, save, write, snapper);
 	max = pos;
 	if (jump != ~0U && jump > max) {
 		max = jump;
@@ -25,12 +27,14 @@ unsigned char*
 	return ptr;
 }
 
-const unsigned char*
-    snap_load_base(const unsigned char* ptr, size_t& pos, size_t& jump, size_t& save, size_t& max)
+const unsigned char* snap_load_base(
+    const unsigned char* ptr, const snapshot_interface::loader& loader, size_t& pos, size_t& jump,
+    size_t& save, size_t& max
+)
 {
-	ptr = snapshot_interface::snap_read(ptr, pos);
-	ptr = snapshot_interface::snap_read(ptr, jump);
-	ptr = snapshot_interface::snap_read(ptr, save);
+	ptr = snapshot_interface::snap_read(ptr, pos, loader);
+	ptr = snapshot_interface::snap_read(ptr, jump, loader);
+	ptr = snapshot_interface::snap_read(ptr, save, loader);
 	max = pos;
 	if (jump != ~0U && jump > max) {
 		max = jump;
@@ -46,7 +50,7 @@ size_t restorable<entry>::snap(unsigned char* data, const snapper& snapper) cons
 {
 	unsigned char* ptr = data;
 	size_t         max;
-	ptr = snap_base(ptr, data != nullptr, _pos, _jump, _save, max);
+	ptr = snap_base(ptr, data != nullptr, snapper, _pos, _jump, _save, max);
 	for (size_t i = 0; i < max; ++i) {
 		ptr = snap_write(ptr, _buffer[i].name, data != nullptr);
 		ptr += _buffer[i].data.snap(data ? ptr : nullptr, snapper);
@@ -59,7 +63,7 @@ size_t restorable<value>::snap(unsigned char* data, const snapper& snapper) cons
 {
 	unsigned char* ptr = data;
 	size_t         max;
-	ptr = snap_base(ptr, data != nullptr, _pos, _jump, _save, max);
+	ptr = snap_base(ptr, data != nullptr, snapper, _pos, _jump, _save, max);
 	for (size_t i = 0; i < max; ++i) {
 		ptr += _buffer[i].snap(data ? ptr : nullptr, snapper);
 	}
@@ -67,13 +71,13 @@ size_t restorable<value>::snap(unsigned char* data, const snapper& snapper) cons
 }
 
 template<>
-size_t restorable<int>::snap(unsigned char* data, const snapper&) const
+size_t restorable<int>::snap(unsigned char* data, const snapper& snapper) const
 {
 	unsigned char* ptr = data;
 	size_t         max;
-	ptr = snap_base(ptr, data != nullptr, _pos, _jump, _save, max);
+	ptr = snap_base(ptr, data != nullptr, snapper, _pos, _jump, _save, max);
 	for (size_t i = 0; i < max; ++i) {
-		ptr = snap_write(ptr, _buffer[i], data != nullptr);
+		ptr = snap_write(ptr, _buffer[i], data != nullptr, snapper);
 	}
 	return static_cast<size_t>(ptr - data);
 }
@@ -82,7 +86,7 @@ template<>
 const unsigned char* restorable<entry>::snap_load(const unsigned char* ptr, const loader& loader)
 {
 	size_t max;
-	ptr = snap_load_base(ptr, _pos, _jump, _save, max);
+	ptr = snap_load_base(ptr, loader, _pos, _jump, _save, max);
 	while (_size < max) {
 		overflow(_buffer, _size);
 	}
@@ -97,7 +101,7 @@ template<>
 const unsigned char* restorable<value>::snap_load(const unsigned char* ptr, const loader& loader)
 {
 	size_t max;
-	ptr = snap_load_base(ptr, _pos, _jump, _save, max);
+	ptr = snap_load_base(ptr, loader, _pos, _jump, _save, max);
 	while (_size < max) {
 		overflow(_buffer, _size);
 	}
@@ -108,15 +112,15 @@ const unsigned char* restorable<value>::snap_load(const unsigned char* ptr, cons
 }
 
 template<>
-const unsigned char* restorable<int>::snap_load(const unsigned char* ptr, const loader&)
+const unsigned char* restorable<int>::snap_load(const unsigned char* ptr, const loader& loader)
 {
 	size_t max;
-	ptr = snap_load_base(ptr, _pos, _jump, _save, max);
+	ptr = snap_load_base(ptr, loader, _pos, _jump, _save, max);
 	while (_size < max) {
 		overflow(_buffer, _size);
 	}
 	for (size_t i = 0; i < max; ++i) {
-		ptr = snap_read(ptr, _buffer[i]);
+		ptr = snap_read(ptr, _buffer[i], loader);
 	}
 	return ptr;
 }
@@ -352,6 +352,29 @@ public:
 		return count;
 	}
 
+	// Replaces the content and the save point with the ones of other
+	void copy_from(const restorable& other)
+	{
+		_pos  = other._pos;
+		_jump = other._jump;
+		_save = other._save;
+
+		// saved data behind the current position is kept too
+		size_t max = _pos;
+		if (_jump != ~0U && _jump > max) {
+			max = _jump;
+		}
+		if (_save != ~0U && _save > max) {
+			max = _save;
+		}
+		while (_size < max) {
+			overflow(_buffer, _size);
+		}
+		for (size_t i = 0; i < max; ++i) {
+			_buffer[i] = other._buffer[i];
+		}
+	}
+
 	// snapshot interface
 	virtual size_t       snap(unsigned char* data, const snapper&) const;
 	const unsigned char* snap_load(const unsigned char* data, const loader&);
@@ -362,6 +385,15 @@ protected:
 	// Called when we run out of space in buffer.
 	virtual void overflow(ElementType*&, size_t&) { inkFail("Restorable run out of memory!"); }
 
+	// Raw positions in the buffer, used to index elements from derived collections
+	size_t top_index() const { return _pos; }
+
+	size_t save_index() const { return _save; }
+
+	ElementType& at(size_t i) { return _buffer[i]; }
+
+	const ElementType& at(size_t i) const { return _buffer[i]; }
+
 private:
 	template<typename Predicate>
 	ElementType* reverse_find_impl(Predicate predicate) const
@@ -14,17 +14,12 @@
 /// Therefore it is required that each argument has a unique type, so that the
 /// order won't matter.
 ///
-/// When call an operation the executioner iterates through all commands and
-/// after find an command match.
-/// Then pop arguments from the stack as defined in `command_num_args`.
-/// After this iterate through the implementations of that command for different
-/// type until it found the correct type, than execute the operation.
-/// The search is O(n), but the list is only populated with commands which have
-/// at least one implementation, also per command only types listed for which
-/// the command is implemented.
-///
-/// Improvements: The executioner -> typed_executer could be O(1) when using a
-/// look up table.
+/// The operations are stored in a chain of executer_imp (one per command)
+/// and typed_executer (one per implemented type of the command). At compile
+/// time a table [Command][value_type] of handlers is generated from the same
+/// chain, so calling an operation is: pop the arguments as defined in
+/// `command_num_args`, find the common type of them and call the handler from
+/// the table. Only commands and types with an implementation get a handler.
 
 #include "system.h"
 #include "value.h"
@@ -72,12 +67,14 @@ public:
 	{
 	}
 
-	void operator()(value_type t, basic_eval_stack& s, value* v)
+	// operation for type t, resolved at compile time
+	template<value_type t>
+	operation<cmd, t>& get()
 	{
-		if (t == ty) {
-			_op(s, v);
+		if constexpr (t == ty) {
+			return _op;
 		} else {
-			_typed_exe(t, s, v);
+			return _typed_exe.template get<t>();
 		}
 	}
 
@@ -98,11 +95,6 @@ public:
 	typed_executer(const T&)
 	{
 	}
-
-	void operator()(value_type, basic_eval_stack&, value*)
-	{
-		inkFail("Operation for value not supported!");
-	}
 };
 
 /**
@@ -126,8 +118,8 @@ constexpr Command next_operatable_command()
 }
 
 /**
- * @brief  Iterate through all commands to find correct command.
- * Also instantiates all typed_executer and with them the operations.
+ * @brief Chain of all commands with at least one operation.
+ * Instantiates all typed_executer and with them the operations.
  */
 template<Command cmd = next_operatable_command<Command::OP_BEGIN, 0>()>
 class executer_imp
@@ -140,23 +132,14 @@ public:
 	{
 	}
 
-	void operator()(Command c, basic_eval_stack& s)
+	// operations of command c, resolved at compile time
+	template<Command c>
+	typed_executer<c>& get()
 	{
-		if (c == cmd) {
-			static constexpr size_t N = command_num_args(cmd);
-			if constexpr (N == 0) {
-				value_type ty = casting::common_base<0>(nullptr);
-				_typed_exe(ty, s, nullptr);
-			} else {
-				value args[N];
-				for (int i = command_num_args(cmd) - 1; i >= 0; --i) {
-					args[i] = s.pop();
-				}
-				value_type ty = casting::common_base<N>(args);
-				_typed_exe(ty, s, args);
-			}
+		if constexpr (c == cmd) {
+			return _typed_exe;
 		} else {
-			_exe(c, s);
+			return _exe.template get<c>();
 		}
 	}
 
@@ -174,10 +157,62 @@ public:
 	executer_imp(const T&)
 	{
 	}
+};
+
+/**
+ * @brief Table of handlers for each command and type, generated from the executer_imp chain.
+ */
+struct operation_dispatch {
+	using operations = executer_imp<Command::OP_BEGIN>;
+	using handler    = void (*)(operations&, basic_eval_stack&, value*);
+
+	static constexpr size_t NumCommands
+	    = static_cast<size_t>(Command::OP_END) - static_cast<size_t>(Command::OP_BEGIN);
+	static constexpr size_t NumTypes = static_cast<size_t>(value_type::OP_END);
 
-	void operator()(Command, basic_eval_stack&) { inkFail("requested command was not found!"); }
+	handler op[NumCommands][NumTypes] = {}; // nullptr if not implemented
+	uint8_t args[NumCommands]         = {}; // see command_num_args
+
+	static constexpr size_t index(Command cmd)
+	{
+		return static_cast<size_t>(cmd) - static_cast<size_t>(Command::OP_BEGIN);
+	}
+
+	template<Command cmd, value_type ty>
+	static void execute(operations& ops, basic_eval_stack& stack, value* args)
+	{
+		ops.template get<cmd>().template get<ty>()(stack, args);
+	}
+
+	template<Command cmd, value_type ty = next_operatable_type<cmd, value_type::BEGIN, 0>()>
+	constexpr void fill_types()
+	{
+		if constexpr (ty != value_type::OP_END) {
+			op[index(cmd)][static_cast<size_t>(ty)] = &execute<cmd, ty>;
+			fill_types<cmd, next_operatable_type<cmd, ty, 1>()>();
+		}
+	}
+
+	template<Command cmd = next_operatable_command<Command::OP_BEGIN, 0>()>
+	constexpr void fill_commands()
+	{
+		if constexpr (cmd != Command::OP_END) {
+			args[index(cmd)] = static_cast<uint8_t>(command_num_args(cmd));
+			fill_types<cmd>();
+			fill_commands<next_operatable_command<cmd, 1>()>();
+		}
+	}
+
+	static constexpr operation_dispatch build()
+	{
+		operation_dispatch table{};
+		table.fill_commands();
+		return table;
+	}
 };
 
+inline constexpr operation_dispatch operation_dispatch_table = operation_dispatch::build();
+
 /**
  * @brief Class which instantiates all operations and give access to them.
  */
@@ -201,9 +236,43 @@ public:
 	 * @param cmd command to execute
 	 * @param stack stack to operate on
 	 */
-	void operator()(Command cmd, basic_eval_stack& stack) { _executer(cmd, stack); }
+	void operator()(Command cmd, basic_eval_stack& stack)
+	{
+		const operation_dispatch& table = operation_dispatch_table;
+		const size_t              idx   = operation_dispatch::index(cmd);
+		inkAssert(idx < operation_dispatch::NumCommands, "requested command was not found!");
+
+		value      args[3];
+		value_type ty = value_type::none;
+		switch (table.args[idx]) {
+			case 0: ty = casting::common_base<0>(nullptr); break;
+			case 1:
+				args[0] = stack.pop();
+				ty      = casting::common_base<1>(args);
+				break;
+			case 2:
+				args[1] = stack.pop();
+				args[0] = stack.pop();
+				ty      = casting::common_base<2>(args);
+				break;
+			case 3:
+				args[2] = stack.pop();
+				args[1] = stack.pop();
+				args[0] = stack.pop();
+				ty      = casting::common_base<3>(args);
+				break;
+		}
+
+		operation_dispatch::handler op
+		    = ty < value_type::OP_END ? table.op[idx][static_cast<size_t>(ty)] : nullptr;
+		if (op == nullptr) {
+			inkFail("Operation for value not supported!");
+			return;
+		}
+		op(_executer, stack, table.args[idx] == 0 ? nullptr : args);
+	}
 
 private:
-	executer_imp<Command::OP_BEGIN> _executer;
+	operation_dispatch::operations _executer;
 };
 } // namespace ink::runtime::internal
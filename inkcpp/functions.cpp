@@ -9,46 +9,80 @@
 namespace ink::runtime::internal
 {
 functions::functions()
-    : _list(nullptr)
-    , _last(nullptr)
+    : _entries(nullptr)
+    , _size(0)
+    , _count(0)
 {
 }
 
 functions::~functions()
 {
-	// clean list
-	while (_list) {
-		entry* toDelete = _list;
-		_list           = _list->next;
-
-		// delete both value and entry
-		delete toDelete->value;
-		delete toDelete;
+	clear();
+	delete[] _entries;
+}
+
+void functions::clear()
+{
+	// delete owned values, the table keeps its size
+	for (size_t i = 0; i < _size; ++i) {
+		if (_entries[i].name != InvalidHash && _entries[i].owned) {
+			delete _entries[i].value;
+		}
+		_entries[i] = {InvalidHash, nullptr, false};
 	}
-	_list = _last = nullptr;
+	_count = 0;
 }
 
-void functions::add(hash_t name, function_base* func)
+void functions::add(hash_t name, function_base* func) { insert(name, func, true); }
+
+void functions::cache(hash_t name, function_base* func) { insert(name, func, false); }
+
+function_base* functions::find(hash_t name) const
 {
-	entry* current = new entry;
-	current->name  = name;
-	current->value = func;
-	current->next  = nullptr;
-
-	if (_list == nullptr) {
-		_list = _last = current;
-	} else {
-		_last->next = current;
-		_last       = current;
+	if (_count == 0) {
+		return nullptr;
 	}
+	const entry& e = slot(name);
+	return e.name == name ? e.value : nullptr;
 }
 
-function_base* functions::find(hash_t name)
+void functions::insert(hash_t name, function_base* func, bool owned)
 {
-	// find entry
-	entry* iter = _list;
-	while (iter != nullptr && iter->name != name)
-		iter = iter->next;
-	return iter == nullptr ? nullptr : iter->value;
+	inkAssert(name != InvalidHash, "Can not bind a function with an invalid name hash!");
+
+	// Keep the table at most half full
+	if ((_count + 1) * 2 > _size) {
+		entry* old      = _entries;
+		size_t old_size = _size;
+		_size           = _size == 0 ? 16 : _size * 2;
+		_entries        = new entry[_size];
+		for (size_t i = 0; i < _size; ++i) {
+			_entries[i] = {InvalidHash, nullptr, false};
+		}
+		for (size_t i = 0; i < old_size; ++i) {
+			if (old[i].name != InvalidHash) {
+				slot(old[i].name) = old[i];
+			}
+		}
+		delete[] old;
+	}
+
+	entry& e = slot(name);
+	if (e.name == InvalidHash) {
+		++_count;
+	} else if (e.owned) {
+		delete e.value;
+	}
+	e = {name, func, owned};
+}
+
+functions::entry& functions::slot(hash_t name) const
+{
+	const size_t mask = _size - 1;
+	size_t       i    = name & mask;
+	while (_entries[i].name != name && _entries[i].name != InvalidHash) {
+		i = (i + 1) & mask;
+	}
+	return _entries[i];
 }
 } // namespace ink::runtime::internal
@@ -13,28 +13,44 @@ namespace ink::runtime::internal
 {
 class basic_eval_stack;
 
-// Stores bound functions
+// Stores bound functions in an open addressing hash table
 class functions
 {
 public:
 	functions();
 	~functions();
 
-	// Adds a function to the registry
+	functions(const functions&)            = delete;
+	functions& operator=(const functions&) = delete;
+
+	// Adds a function to the registry, replacing a function added before with the same name
 	void add(hash_t name, function_base* func);
 
-	// Calls a function (if available)
-	function_base* find(hash_t name);
+	// Remembers a function owned by another registry. Replaced when a function with the same
+	// name is added, and never deleted by this registry.
+	void cache(hash_t name, function_base* func);
+
+	// Finds a function (if available)
+	function_base* find(hash_t name) const;
+
+	// Removes all functions from the registry
+	void clear();
 
 private:
 	struct entry {
 		hash_t         name;
 		function_base* value;
-		entry*         next;
+		bool           owned;
 	};
 
-	// TODO: Better than a linked list?
-	entry* _list;
-	entry* _last;
+	// Stores func for name, growing the table if needed
+	void insert(hash_t name, function_base* func, bool owned);
+
+	// Slot holding name, or the empty slot where it belongs
+	entry& slot(hash_t name) const;
+
+	entry* _entries;
+	size_t _size;
+	size_t _count;
 };
 } // namespace ink::runtime::internal
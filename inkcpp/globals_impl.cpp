@@ -12,6 +12,10 @@
 #include "types.h"
 #include "value.h"
 
+#ifdef INK_ENABLE_STL
+#	include <chrono>
+#endif
+
 namespace ink::runtime::internal
 {
 globals_impl::globals_impl(const story_impl* story)
@@ -52,7 +56,9 @@ void globals_impl::init_static_list_flags()
 
 void globals_impl::visit(uint32_t container_id)
 {
-	_visit_counts.set(container_id, {_visit_counts[container_id].visits + 1, 0});
+	_visit_counts.set(
+	    container_id, {_visit_counts[container_id].visits + 1, static_cast<int32_t>(_turn_cnt)}
+	);
 }
 
 uint32_t globals_impl::visits(uint32_t container_id) const
@@ -62,21 +68,11 @@ uint32_t globals_impl::visits(uint32_t container_id) const
 
 uint32_t globals_impl::turns() const { return _turn_cnt; }
 
-void globals_impl::turn()
-{
-	++_turn_cnt;
-	for (size_t i = 0; i < _visit_counts.capacity(); ++i) {
-		visit_count visits = _visit_counts[i];
-		if (visits.turns != -1) {
-			visits.turns += 1;
-			_visit_counts.set(i, visits);
-		}
-	}
-}
+void globals_impl::turn() { ++_turn_cnt; }
 
 uint32_t globals_impl::turns(uint32_t container_id) const
 {
-	return _visit_counts[container_id].turns;
+	return turns_since(_visit_counts[container_id]).turns;
 }
 
 void globals_impl::add_runner(const runner_impl* runner)
@@ -114,6 +110,13 @@ void globals_impl::remove_runner(const runner_impl* runner)
 
 void globals_impl::set_variable(hash_t name, const value& val)
 {
+	size_t first = first_callback(name);
+	if (first == _callbacks.size() || _callbacks[first].name != name) {
+		// nobody observes the variable
+		_variables.set(name, val);
+		return;
+	}
+
 	ink::optional<value> old_var   = ink::nullopt;
 	value*               p_old_var = get_variable(name);
 	if (p_old_var != nullptr) {
@@ -122,17 +125,63 @@ void globals_impl::set_variable(hash_t name, const value& val)
 
 	_variables.set(name, val);
 
-	for (auto& callback : _callbacks) {
-		if (callback.name == name) {
-			if (old_var.has_value()) {
-				callback.operation->call(
-				    val.to_interface_value(lists()), {old_var->to_interface_value(lists())}
-				);
-			} else {
-				callback.operation->call(val.to_interface_value(lists()), ink::nullopt);
+	if (_defer_observers) {
+		// the observers get the value before the first write of the line
+		for (const pending_write& write : _pending) {
+			if (write.name == name) {
+				return;
 			}
 		}
+		_pending.push() = pending_write{name, old_var};
+		return;
 	}
+	call_observers(first, val, old_var);
+}
+
+size_t globals_impl::first_callback(hash_t name) const
+{
+	size_t begin = 0;
+	size_t end   = _callbacks.size();
+	while (begin < end) {
+		size_t mid = (begin + end) / 2;
+		if (_callbacks[mid].name < name) {
+			begin = mid + 1;
+		} else {
+			end = mid;
+		}
+	}
+	return begin;
+}
+
+void globals_impl::call_observers(size_t first, const value& val, const optional<value>& old_val)
+{
+	const hash_t name = _callbacks[first].name;
+	for (size_t i = first; i < _callbacks.size() && _callbacks[i].name == name; ++i) {
+		if (old_val.has_value()) {
+			_callbacks[i].operation->call(
+			    val.to_interface_value(lists()), {old_val->to_interface_value(lists())}
+			);
+		} else {
+			_callbacks[i].operation->call(val.to_interface_value(lists()), ink::nullopt);
+		}
+	}
+}
+
+void globals_impl::flush_observers()
+{
+	for (size_t i = 0; i < _pending.size(); ++i) {
+		const pending_write write = _pending[i];
+		call_observers(first_callback(write.name), *get_variable(write.name), write.old_val);
+	}
+	_pending.clear();
+}
+
+void globals_impl::defer_observers(bool defer)
+{
+	if (! defer) {
+		flush_observers();
+	}
+	_defer_observers = defer;
 }
 
 const value* globals_impl::get_variable(hash_t name) const { return _variables.get(name); }
@@ -179,10 +228,9 @@ bool globals_impl::set_var(hash_t name, const ink::runtime::value& val)
 		ret = var->set(val);
 	}
 
-	for (auto& callback : _callbacks) {
-		if (callback.name == name) {
-			callback.operation->call(val, {old_val});
-		}
+	for (size_t i = first_callback(name); i < _callbacks.size() && _callbacks[i].name == name;
+	     ++i) {
+		_callbacks[i].operation->call(val, {old_val});
 	}
 
 	return ret;
@@ -190,7 +238,12 @@ bool globals_impl::set_var(hash_t name, const ink::runtime::value& val)
 
 void globals_impl::internal_observe(hash_t name, callback_base* callback)
 {
-	_callbacks.push() = Callback{name, callback};
+	// after the observers already added for this variable
+	size_t position = first_callback(name);
+	while (position < _callbacks.size() && _callbacks[position].name == name) {
+		++position;
+	}
+	_callbacks.insert(position) = Callback{name, callback};
 	if (_globals_initialized) {
 		value* p_var = _variables.get(name);
 		inkAssert(
@@ -217,6 +270,17 @@ void globals_impl::initialize_globals(runner_impl* run)
 
 void globals_impl::gc()
 {
+	// Marking walks every runner, skip it until enough garbage could have piled up
+	if (_strings.created() + _lists.created() < static_cast<size_t>(config::gcAllocationThreshold)
+	    && ! _strings.nearly_full() && ! _lists.nearly_full()) {
+		_lists.release_handouts();
+		++_gc_stats.skipped;
+		return;
+	}
+#ifdef INK_ENABLE_STL
+	auto start = std::chrono::steady_clock::now();
+#endif
+
 	// Mark all strings as unused
 	_strings.clear_usage();
 	_lists.clear_usage();
@@ -231,21 +295,44 @@ void globals_impl::gc()
 	// Mark our own strings
 	_variables.mark_used(_strings, _lists);
 
+	// and the old values of deferred writes
+	for (const pending_write& write : _pending) {
+		if (! write.old_val.has_value()) {
+			continue;
+		}
+		const value& old_val = *write.old_val;
+		if (old_val.type() == value_type::string && old_val.get<value_type::string>().allocated) {
+			_strings.mark_used(old_val.get<value_type::string>().str);
+		} else if (old_val.type() == value_type::list) {
+			_lists.mark_used(old_val.get<value_type::list>());
+		}
+	}
+
 	// run garbage collection
-	_strings.gc();
-	_lists.gc();
+	_gc_stats.strings_freed += static_cast<int>(_strings.gc());
+	_gc_stats.lists_freed += static_cast<int>(_lists.gc());
+	++_gc_stats.collections;
+#ifdef INK_ENABLE_STL
+	std::chrono::duration<double, std::micro> took = std::chrono::steady_clock::now() - start;
+	_gc_stats.time_us += static_cast<int>(took.count());
+#endif
 }
 
 void globals_impl::save()
 {
 	_visit_counts.save();
 	_variables.save();
+	_pending_save = _pending.size();
 }
 
 void globals_impl::restore()
 {
 	_visit_counts.restore();
 	_variables.restore();
+	// writes of the lookahead never happened
+	if (_pending.size() > _pending_save) {
+		_pending.resize(_pending_save);
+	}
 }
 
 void globals_impl::forget()
@@ -256,6 +343,11 @@ void globals_impl::forget()
 
 snapshot* globals_impl::create_snapshot() const { return new snapshot_impl(*this); }
 
+snapshot* globals_impl::create_delta_snapshot(const snapshot& base) const
+{
+	return new snapshot_impl(*this, reinterpret_cast<const snapshot_impl&>(base));
+}
+
 bool globals_impl::can_be_migrated() const
 {
 	return _visit_counts.can_be_migrated() && _strings.can_be_migrated() && _lists.can_be_migrated()
@@ -270,9 +362,14 @@ size_t globals_impl::snap(unsigned char* data, const snapper& snapper) const
 	    _globals_initialized,
 	    "Only support snapshot of globals with runner! or you don't need a snapshot for this state"
 	);
-	ptr = snap_write(ptr, _turn_cnt, data != nullptr);
-	ptr += _visit_counts.snap(data ? ptr : nullptr, snapper);
+	auto turns = [this](const visit_count& vc) { return turns_since(vc); };
+	ptr        = snap_write(ptr, _turn_cnt, data != nullptr, snapper);
+	ptr += _visit_counts.snap(data ? ptr : nullptr, snapper, turns);
 	for (unsigned i = 0; i < _visit_counts.capacity(); ++i) {
+		// the compact format only keeps the paths of visited containers, to find them on migration
+		if (snapper.compact && _visit_counts.is_default(i, turns)) {
+			continue;
+		}
 		ptr = snap_write(ptr, _owner->container_data(i)._hash, data != nullptr);
 	}
 	ptr += _strings.snap(data ? ptr : nullptr, snapper);
@@ -283,10 +380,12 @@ size_t globals_impl::snap(unsigned char* data, const snapper& snapper) const
 
 const unsigned char* globals_impl::snap_load(const unsigned char* ptr, const loader& loader)
 {
+	auto turns           = [this](const visit_count& vc) { return turns_since(vc); };
 	_globals_initialized = true;
-	ptr                  = snap_read(ptr, _turn_cnt);
+	ptr                  = snap_read(ptr, _turn_cnt, loader);
 	ptr                  = _visit_counts.snap_load(ptr, loader);
-	size_t old_capacity  = _visit_counts.loaded_capacity();
+	_visit_counts.map_loaded(turns);
+	size_t old_capacity = _visit_counts.loaded_capacity();
 	// shuffle values if needed
 	if (loader.migratable) {
 		// extend array if needed
@@ -301,6 +400,14 @@ const unsigned char* globals_impl::snap_load(const unsigned char* ptr, const loa
 	    "Missmatching number of tracked containers."
 	);
 	for (size_t i = 0; i < old_capacity; ++i) {
+		// the writer skipped unvisited containers. Snapshots which can be migrated have no changes
+		// since a save, so while migrating only the saved value tells, as the migration changes
+		// entries ahead
+		if (loader.compact
+		    && (loader.migratable ? turns(_visit_counts.get_old(i)) == visit_count{}
+		                          : _visit_counts.is_default(i, turns))) {
+			continue;
+		}
 		hash_t path;
 		ptr = snap_read(ptr, path);
 		container_t c_id;
@@ -347,7 +454,8 @@ bool globals_impl::migrate_new_globals(globals_impl& new_globals, const char* li
 config::statistics::global globals_impl::statistics() const
 {
 	return {
-	    _variables.statistics(), _callbacks.statistics(), _lists.statistics(), _strings.statistics()
+	    _variables.statistics(), _callbacks.statistics(), _lists.statistics(), _strings.statistics(),
+	    _gc_stats,
 	};
 }
 
@@ -57,6 +57,9 @@ public:
 	}
 
 	snapshot* create_snapshot() const override;
+	snapshot* create_delta_snapshot(const snapshot& base) const override;
+
+	void defer_observers(bool defer) override;
 
 protected:
 	optional<ink::runtime::value> get_var(hash_t name) const override;
@@ -83,9 +86,15 @@ public:
 	void add_runner(const runner_impl*);
 	void remove_runner(const runner_impl*);
 
+	// checks if more than one runner uses this globals object
+	bool is_shared() const { return _runners_start != nullptr && _runners_start->next != nullptr; }
+
 	// sets a global variable
 	void set_variable(hash_t name, const value&);
 
+	// calls the observers of the writes deferred since the last call
+	void flush_observers();
+
 	// gets a global variable
 	const value* get_variable(hash_t name) const;
 	value*       get_variable(hash_t name);
@@ -104,7 +113,7 @@ public:
 	// gets list entries
 	list_table& lists() { return _lists; }
 
-	// run garbage collection
+	// run garbage collection, if enough was allocated since the last one
 	void gc();
 
 	// == Save/Restore ==
@@ -123,7 +132,7 @@ private:
 	// Visit count array
 	struct visit_count {
 		uint32_t visits = 0;
-		int32_t  turns  = -1;
+		int32_t  turns  = -1; // turn of the last visit, snapshots store the turns since then
 
 		bool operator==(const visit_count& vc) const
 		{
@@ -135,6 +144,15 @@ private:
 
 	static constexpr visit_count visit_count_null_value{~0U, -2};
 
+	// converts between turn of the last visit and turns since then, works in both directions
+	visit_count turns_since(const visit_count& vc) const
+	{
+		if (vc.turns < 0) {
+			return vc;
+		}
+		return {vc.visits, static_cast<int32_t>(_turn_cnt) - vc.turns};
+	}
+
 	internal::allocated_restorable_array<visit_count> _visit_counts;
 
 	// Pointer back to owner story.
@@ -153,17 +171,37 @@ private:
 	mutable string_table _strings;
 	mutable list_table   _lists;
 
-	// Implemented as a stack (slow lookup) because it has save/restore functionality.
-	// If I could create an avl tree with save/restore, that'd be great but seems super complex.
-	internal::stack < abs(config::limitGlobalVariables), config::limitGlobalVariables<0> _variables;
+	config::statistics::gc _gc_stats = {};
+
+	// Implemented as a stack because it has save/restore functionality, with a hash index for lookup
+	internal::variable_stack < abs(config::limitGlobalVariables),
+	    config::limitGlobalVariables<0> _variables;
 
 	struct Callback {
 		hash_t         name;
 		callback_base* operation;
 	};
 
+	// position of the first observer of name, or where it would be inserted
+	size_t first_callback(hash_t name) const;
+
+	// calls the observers of the variable, starting with the one at first
+	void call_observers(size_t first, const value& val, const optional<value>& old_val);
+
+	// Sorted by name, observers of the same variable in the order they were added
 	managed_array < Callback,
 	    config::limitGlobalVariableObservers<0, abs(config::limitGlobalVariableObservers)> _callbacks;
-	bool _globals_initialized;
+
+	// observed variable written while observers are deferred, with its value before the first write
+	struct pending_write {
+		hash_t          name;
+		optional<value> old_val;
+	};
+
+	managed_array < pending_write,
+	    config::limitGlobalVariableObservers<0, abs(config::limitGlobalVariableObservers)> _pending;
+	size_t _pending_save    = 0;
+	bool   _defer_observers = false;
+	bool   _globals_initialized;
 };
 } // namespace ink::runtime::internal
@@ -22,7 +22,7 @@ bool header::verify() const
 		return false;
 	}
 
-	if (ink_bin_version_number != InkBinVersion) {
+	if (ink_bin_version_number < InkBinVersionMin || ink_bin_version_number > InkBinVersion) {
 		inkFail("InkCpp-version mismatch: file was compiled with different InkCpp-version!");
 		return false;
 	}
@@ -0,0 +1,150 @@
+/* Copyright (c) 2024 Julian Benda
+ *
+ * This file is part of inkCPP which is released under MIT license.
+ * See file LICENSE.txt or go to
+ * https://github.com/JBenda/inkcpp for full license details.
+ */
+#pragma once
+
+#include "config.h"
+#include "system.h"
+#include "types.h"
+
+#if defined(INK_ENABLE_STL) && defined(INK_ENABLE_THREADS)
+#	include <string>
+#	include <vector>
+
+namespace ink::runtime
+{
+namespace internal
+{
+	class batch_pool;
+}
+
+/**
+ * Output of one runner in a batch, collected by @ref batch_executor::run().
+ *
+ * The strings are kept between runs and overwritten, so once they are large enough collecting a
+ * result does not allocate.
+ */
+class batch_result
+{
+public:
+	/** number of lines read in the last run */
+	size_t num_lines() const { return _num_lines; }
+
+	/** text of a line read in the last run, including the trailing newline */
+	const std::string& line(size_t index) const;
+
+	/** number of tags of a line read in the last run */
+	size_t num_tags(size_t line) const;
+
+	/** tag of a line read in the last run */
+	const std::string& tag(size_t line, size_t index) const;
+
+	/** number of choices available after the last run */
+	size_t num_choices() const { return _num_choices; }
+
+	/** text of a choice available after the last run */
+	const std::string& choice(size_t index) const;
+
+	/** if the runner can continue after the last run */
+	bool can_continue() const { return _can_continue; }
+
+	/** if the runner waits for an asynchronous external function, see @ref
+	 * runner_interface::bind_async() */
+	bool suspended() const { return _suspended; }
+
+private:
+	friend class internal::batch_pool;
+
+	void clear();
+
+	// next unused string of list, reusing its storage
+	static std::string& next(std::vector<std::string>& list, size_t& count);
+
+	std::vector<std::string> _lines;
+	std::vector<std::string> _tags;
+	// index into _tags of the first tag of each line, followed by the end of the last line
+	std::vector<size_t>      _line_tags = {0};
+	std::vector<std::string> _choices;
+	size_t                   _num_lines    = 0;
+	size_t                   _num_tags     = 0;
+	size_t                   _num_choices  = 0;
+	bool                     _can_continue = false;
+	bool                     _suspended    = false;
+};
+
+/**
+ * Steps many independent runners on a pool of worker threads.
+ *
+ * Runners are added once and get a slot. Before each @ref run() an action is queued per slot:
+ * optionally take a choice, then read a number of lines. run() executes the actions of all
+ * slots in parallel and collects lines, tags and choices into the result of each slot.
+ *
+ * Each slot is a contiguous range of work owned by one worker, workers which run out of work
+ * steal slots from the ranges of the others. The thread calling run() works as one of them.
+ *
+ * Runners in a batch must use their own globals, and must not be used elsewhere during run().
+ * Requires INK_ENABLE_STL and INK_ENABLE_THREADS.
+ */
+class batch_executor
+{
+public:
+	/**
+	 * Starts the worker threads.
+	 * @param threads number of threads stepping runners, including the one calling run(). 0 uses
+	 * one per hardware thread
+	 */
+	explicit batch_executor(size_t threads = 0);
+	~batch_executor();
+
+	batch_executor(const batch_executor&)            = delete;
+	batch_executor& operator=(const batch_executor&) = delete;
+
+	/**
+	 * Adds a runner to the batch.
+	 * @param thread runner with its own globals
+	 * @return slot of the runner
+	 */
+	size_t add(runner thread);
+
+	/** number of runners in the batch */
+	size_t size() const;
+
+	/** number of threads stepping runners */
+	size_t num_threads() const;
+
+	/** runner in a slot */
+	runner& get(size_t slot);
+
+	/**
+	 * Takes a choice at the start of the next run.
+	 * @param slot slot of the runner
+	 * @param index choice index, see @ref runner_interface::choose()
+	 */
+	void choose(size_t slot, size_t index);
+
+	/**
+	 * Sets the number of lines read in each run.
+	 * @param slot slot of the runner
+	 * @param lines lines to read, 0 reads until the next choice or the end of the story (default)
+	 */
+	void continue_lines(size_t slot, size_t lines);
+
+	/**
+	 * Executes the queued actions of all slots and waits until they are done.
+	 *
+	 * Queued choices are consumed, the number of lines stays for later runs. If a runner fails,
+	 * the first error is thrown after all slots are done.
+	 */
+	void run();
+
+	/** output of a slot from the last run */
+	const batch_result& result(size_t slot) const;
+
+private:
+	internal::batch_pool* _pool;
+};
+} // namespace ink::runtime
+#endif
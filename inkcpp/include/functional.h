@@ -121,8 +121,9 @@ private:
 class function_base
 {
 public:
-	function_base(bool lookaheadSafe)
+	function_base(bool lookaheadSafe, bool async = false)
 	    : _lookaheadSafe(lookaheadSafe)
+	    , _async(async)
 	{
 	}
 
@@ -140,10 +141,20 @@ public:
 	    = 0;
 #endif
 
+	// calls an asynchronous function, which gets the token of the suspended call instead of
+	// returning a result, see runner_interface::bind_async()
+	virtual void call_async(basic_eval_stack*, size_t, list_table&, uint32_t)
+	{
+		inkFail("Function can not be called asynchronously");
+	}
+
 	bool lookaheadSafe() const { return _lookaheadSafe; }
 
+	bool async() const { return _async; }
+
 protected:
 	bool _lookaheadSafe;
+	bool _async;
 	// used to hide basic_eval_stack and value definitions
 	template<typename T>
 	static T pop(basic_eval_stack* stack, list_table& lists);
@@ -277,6 +288,52 @@ private:
 	}
 };
 
+// Stores a Callable object, which is called with the token of the suspended call followed by the
+// arguments, and delivers its result later with runner_interface::resume_external()
+template<typename F>
+class async_function : public function_base
+{
+public:
+	async_function(F functor)
+	    : function_base(false, true)
+	    , functor(functor)
+	{
+	}
+
+	virtual void call(basic_eval_stack*, size_t, string_table&, list_table&) override
+	{
+		inkFail("Asynchronous functions can only be called with call_async");
+	}
+
+	virtual void call_async(
+	    basic_eval_stack* stack, size_t length, list_table& lists, uint32_t token
+	) override
+	{
+		call_async(stack, length, lists, token, GenSeq<traits::arity - 1>());
+	}
+
+private:
+	// Callable functor object
+	F functor;
+
+	// function traits
+	using traits = function_traits<F>;
+	static_assert(traits::arity > 0, "Asynchronous functions take the token as first argument");
+
+	// argument types, without the token
+	template<int index>
+	using arg_type = typename function_traits<F>::template argument<index + 1>::type;
+
+	template<size_t... Is>
+	void call_async(
+	    basic_eval_stack* stack, size_t length, list_table& lists, uint32_t token, seq<Is...>
+	)
+	{
+		inkAssert(sizeof...(Is) == length, "Attempting to call functor with too few/many arguments");
+		functor(token, pop<arg_type<Is>>(stack, lists)...);
+	}
+};
+
 #ifdef INK_ENABLE_UNREAL
 template<typename D>
 class function_array_delegate : public function_base
@@ -66,6 +66,18 @@ public:
 		internal_observe(hash_string(name), new internal::callback(callback));
 	}
 
+	/**
+	 * @brief Calls the observers once per line instead of on every write.
+	 *
+	 * While enabled, the observers of a variable the story writes are called after the line is
+	 * finished, once with the value before the first and the value after the last write of the
+	 * line. Writes undone after a glue lookahead do not call them at all. Writes with
+	 * @ref set() still call the observers right away.
+	 * Disabling calls the observers of writes which are still waiting.
+	 * @param defer true to call the observers after the line
+	 */
+	virtual void defer_observers(bool defer) = 0;
+
 	/** Get usage statistics for global. */
 	virtual config::statistics::global statistics() const = 0;
 
@@ -74,6 +86,13 @@ public:
 	 */
 	virtual snapshot* create_snapshot() const = 0;
 
+	/** create a snapshot which only stores the changes since base.
+	 * The blob of the returned snapshot is usually much smaller than the one of a full snapshot,
+	 * it is loaded with @ref ink::runtime::snapshot::from_delta() and the same base.
+	 * @param base earlier snapshot of this story, full or delta
+	 */
+	virtual snapshot* create_delta_snapshot(const snapshot& base) const = 0;
+
 	virtual ~globals_interface() = default;
 
 protected:
@@ -76,6 +76,36 @@ public:
 	 */
 	virtual bool can_continue() const = 0;
 
+	/** token of a suspended call of an asynchronous external function, see @ref bind_async() */
+	using async_call = uint32_t;
+
+	/**
+	 * Is the runner waiting for the result of an asynchronous external function?
+	 *
+	 * The runner suspends in the middle of a line, getline() then returns an empty line and
+	 * @ref can_continue() is false. The choices are incomplete if the call happened while they
+	 * were collected. After @ref resume_external() the next getline() finishes the interrupted
+	 * line. The suspended state is part of snapshots.
+	 * @sa bind_async
+	 */
+	virtual bool is_suspended() const = 0;
+
+	/**
+	 * Delivers the result of an asynchronous external function, so the runner can continue.
+	 *
+	 * May also be called by the function itself, then the runner does not suspend.
+	 * @param token token the function was called with
+	 * @param result return value of the function
+	 */
+	virtual void resume_external(async_call token, value result) = 0;
+
+	/**
+	 * Ends the call of an asynchronous external function without a return value.
+	 * @param token token the function was called with
+	 * @sa resume_external(async_call, value)
+	 */
+	virtual void resume_external(async_call token) = 0;
+
 	/**
 	 * @brief creates a snapshot containing the runner, globals and all other runners connected to the
 	 * globals.
@@ -83,6 +113,22 @@ public:
 	 */
 	virtual snapshot* create_snapshot() const = 0;
 
+	/**
+	 * @brief creates a snapshot which only stores the changes since base.
+	 * @sa globals_interface::create_delta_snapshot, snapshot::from_delta
+	 */
+	virtual snapshot* create_delta_snapshot(const snapshot& base) const = 0;
+
+	/**
+	 * @brief creates a new runner at the same position as this one.
+	 *
+	 * The copy shares the globals with this runner, so no strings or variables are copied.
+	 * External functions bound to this runner are not copied and need to be bound again, functions
+	 * bound to the story are shared.
+	 * @sa story::acquire_runner
+	 */
+	virtual runner clone() const = 0;
+
 	/**
 	 * Continue execution until the next newline, then allocate a c-style
 	 * string with the output. This allocated string is managed by the runtime
@@ -93,6 +139,44 @@ public:
 	 */
 	virtual const char* getline_alloc() = 0;
 
+	/**
+	 * Execute the next line of the script and copy it into a buffer.
+	 *
+	 * The text is written directly from the output without allocating. If the line does not fit
+	 * (including the terminating null), it is kept and returned by the next getline call, so it
+	 * can be retried with a larger buffer. A call with size 0 queries the length of the next line.
+	 * While a line is kept @ref ink::runtime::runner_interface::can_continue() "can_continue()"
+	 * returns true. A kept line is part of snapshots.
+	 *
+	 * @param buffer destination, may be nullptr if size is 0
+	 * @param size capacity of buffer
+	 * @return length of the line without the terminating null. If it is >= size, the line was not
+	 * written
+	 */
+	virtual size_t getline(char* buffer, size_t size) = 0;
+
+	/**
+	 * Receives the text of a line piece by piece.
+	 * @param context pointer passed to @ref ink::runtime::runner_interface::stream_line()
+	 * "stream_line()"
+	 * @param text start of the span, not null terminated and only valid during the call
+	 * @param length number of characters in the span
+	 */
+	using line_sink = void (*)(void* context, const char* text, size_t length);
+
+	/**
+	 * Execute the next line of the script and pass it to sink as a sequence of text spans.
+	 *
+	 * Text from the story and from string variables is passed as spans pointing directly into the
+	 * string storage of the story, numbers and list names are formatted into a small scratch buffer
+	 * first. Concatenating all spans results in the same text getline() would return. The sink must
+	 * not call back into the runner.
+	 *
+	 * @param sink called for each span in order
+	 * @param context passed unchanged to sink
+	 */
+	virtual void stream_line(line_sink sink, void* context) = 0;
+
 #if defined(INK_ENABLE_STL) || defined(INK_ENABLE_UNREAL)
 	/**
 	 * Execute the next line of the script.
@@ -124,6 +208,15 @@ public:
 	 */
 	virtual void getline(std::ostream&) = 0;
 
+	/**
+	 * Gets the next line of output into an existing string.
+	 *
+	 * Continue execution until the next newline, then replace the content of line with the output.
+	 * The storage of line is reused, so reading lines into the same string does not allocate once
+	 * it is large enough. Requires INK_ENABLE_STL
+	 */
+	virtual void getline(std::string& line) = 0;
+
 	/**
 	 * Gets all the text until the next choice or end
 	 *
@@ -279,6 +372,8 @@ public:
 	 * + void(size_t argl, const ink::runtime::value* argv)
 	 * + ink::runtime::value(size_t argl, const ink::runtime::value* argv)
 	 * this provides a generic way to bind functions with abitrary length
+	 *
+	 * Overrides a function with the same name bound to the story with story::bind().
 	 * @param name name hash
 	 * @param function callable
 	 * @param lookaheadSafe if false stop glue lookahead if encounter this function
@@ -309,6 +404,38 @@ public:
 		bind(ink::hash_string(name), function, lookaheadSafe);
 	}
 
+	/**
+	 * Binds an external callable, which delivers its result later.
+	 *
+	 * The callable is called with the token of the call, followed by the arguments, and returns
+	 * nothing. The runner suspends until the result is passed to @ref resume_external(), so slow
+	 * functions (e.g. a request to a server) do not block the thread stepping the runner. Tokens
+	 * are unique per runner.
+	 *
+	 * Asynchronous functions are never executed during glue lookahead, like functions bound with
+	 * lookaheadSafe = false.
+	 * @param name name hash
+	 * @param function callable with the signature void(async_call token, Args...)
+	 * @sa is_suspended
+	 */
+	template<typename F>
+	inline void bind_async(hash_t name, F function)
+	{
+		internal_bind(name, new internal::async_function(function));
+	}
+
+	/**
+	 * Binds an external callable, which delivers its result later.
+	 * @param name name string
+	 * @param function callable with the signature void(async_call token, Args...)
+	 * @sa bind_async(hash_t, F)
+	 */
+	template<typename F>
+	inline void bind_async(const char* name, F function)
+	{
+		bind_async(ink::hash_string(name), function);
+	}
+
 #ifdef INK_ENABLE_UNREAL
 	/** bind and unreal delegate
 	 * @param name hash of external function name in ink script
@@ -326,6 +453,23 @@ public:
 
 #pragma region Convenience Methods
 
+	/**
+	 * Execute the next line of the script and pass it to a callable as a sequence of text spans.
+	 *
+	 * @param sink callable with the signature void(const char* text, size_t length)
+	 * @sa stream_line(line_sink, void*)
+	 */
+	template<typename F>
+	inline void stream_line(F sink)
+	{
+		stream_line(
+		    [](void* context, const char* text, size_t length) {
+			    (*static_cast<F*>(context))(text, length);
+		    },
+		    &sink
+		);
+	}
+
 	/**
 	 * Shortcut for checking if the runner can continue.
 	 *
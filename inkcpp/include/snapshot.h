@@ -67,6 +67,16 @@ public:
 	 */
 	static snapshot* from_binary(const unsigned char* data, size_t length, bool freeOnDestroy = true);
 
+	/** Reconstruct a snapshot from the blob of a delta snapshot.
+	 * @param base snapshot the delta was created against, see
+	 * @ref ink::runtime::globals_interface::create_delta_snapshot()
+	 * @param data pointer to the blob of the delta snapshot, only used during the call
+	 * @param length number of bytes in blob
+	 * @return newly created snapshot, identical to the one the delta was created from
+	 * @throws ink_exception if base is not the snapshot the delta was created against
+	 */
+	static snapshot* from_delta(const snapshot& base, const unsigned char* data, size_t length);
+
 	/** access blob inside snapshot */
 	virtual const unsigned char* get_data() const        = 0;
 	/** size of blob inside snapshot */
@@ -75,6 +85,11 @@ public:
 	virtual size_t               num_runners() const     = 0;
 	/** if this snapshot can be migrated, if the story file changes (slightly). */
 	virtual bool                 can_be_migrated() const = 0;
+	/** if the blob only contains the changes to a base snapshot.
+	 * Such a blob must be loaded with @ref ink::runtime::snapshot::from_delta() "from_delta()",
+	 * the snapshot object itself can be used like a full snapshot.
+	 */
+	virtual bool                 is_delta() const        = 0;
 
 #ifdef INK_ENABLE_STL
 	/** deserialize snapshot from file.
@@ -6,6 +6,7 @@
  */
 #pragma once
 
+#include "functional.h"
 #include "types.h"
 
 namespace ink::runtime
@@ -70,13 +71,78 @@ public:
 	    new_runner_from_snapshot(const snapshot& obj, globals store = nullptr, unsigned runner_id = 0)
 	    = 0;
 
+	/**
+	 * Takes a runner from the pool of released runners
+	 *
+	 * Behaves like @ref new_runner(), but reuses a runner returned
+	 * with @ref release_runner(), including the memory its stacks
+	 * and buffers have grown to. Creates a new runner if the pool is empty.
+	 *
+	 * @param store globals to use for the runner
+	 * @return managed pointer to a runner at the start of the story
+	 */
+	virtual runner acquire_runner(globals store = nullptr) = 0;
+
+	/**
+	 * Returns a runner to the pool
+	 *
+	 * The runner is kept for @ref acquire_runner(), if this is the last pointer
+	 * to it and the pool has room (see @ref config::limitRunnerPool), else it is
+	 * just released. Either way thread is nullptr afterwards.
+	 *
+	 * @param thread runner to give back
+	 */
+	virtual void release_runner(runner& thread) = 0;
+
 	/**
 	 * @brief hash of binary/story.
 	 * used to check for story changes.
 	 */
 	virtual hash_t hash() const = 0;
+
+	/** Get usage statistics for the story. */
+	virtual config::statistics::story statistics() const = 0;
 #pragma endregion
 
+protected:
+	/** internal bind implementation. not for calling.
+	 * @private */
+	virtual void internal_bind(hash_t name, internal::function_base* function) = 0;
+
+public:
+	/**
+	 * Binds an external callable for all runners of this story
+	 *
+	 * The function is shared by all runners, including runners created before, so it is bound
+	 * once instead of once per runner. A function bound to a runner with
+	 * runner_interface::bind() overrides the function of the story for that runner.
+	 *
+	 * Runners on different threads may call the function at the same time. Bind all functions
+	 * before the runners are stepped, binding is not thread safe. A name can only be bound once.
+	 * @param name name hash
+	 * @param function callable, with a signature supported by runner_interface::bind()
+	 * @param lookaheadSafe if false stop glue lookahead if encounter this function
+	 * @sa runner_interface::bind()
+	 */
+	template<typename F>
+	inline void bind(hash_t name, F function, bool lookaheadSafe = false)
+	{
+		internal_bind(name, new internal::function(function, lookaheadSafe));
+	}
+
+	/**
+	 * Binds an external callable for all runners of this story
+	 * @param name name string
+	 * @param function callable
+	 * @param lookaheadSafe if false stop glue lookahead if encounter this function
+	 * @sa bind(hash_t, F, bool)
+	 */
+	template<typename F>
+	inline void bind(const char* name, F function, bool lookaheadSafe = false)
+	{
+		bind(ink::hash_string(name), function, lookaheadSafe);
+	}
+
 #pragma region Factory Methods
 	/**
 	 * Creates a new story object from a file.
@@ -103,6 +169,18 @@ public:
 	 * @return new story object
 	 */
 	static story* from_binary(const unsigned char* data, size_t length, bool freeOnDestroy = true);
+
+	/**
+	 * Creates a new story object from a read-only memory mapping of a file.
+	 *
+	 * Requires an OS with memory mapped files (INK_ENABLE_MMAP). The file is not
+	 * copied, so processes loading the same story share its pages through the page
+	 * cache. The file must not be modified while the story exists.
+	 *
+	 * @param filename filename of the binary ink data
+	 * @return new story object
+	 */
+	static story* from_mmap(const char* filename);
 #pragma endregion
 };
 } // namespace ink::runtime
@@ -8,6 +8,10 @@
 
 #include "system.h"
 
+#ifdef INK_ENABLE_THREADS
+#	include <atomic>
+#endif
+
 namespace ink::runtime
 {
 namespace internal
@@ -22,8 +26,14 @@ namespace internal
 
 		static void remove_reference(ref_block*&);
 
+#ifdef INK_ENABLE_THREADS
+		// pointers to objects of one story may be copied and dropped on different threads
+		std::atomic<size_t> references;
+		std::atomic<bool>   valid;
+#else
 		size_t references;
 		bool   valid;
+#endif
 	};
 
 	/** @private */
@@ -56,6 +66,12 @@ namespace internal
 			    && _instance_block->valid;
 		}
 
+		/** checks if this is the only pointer to the object */
+		inline bool is_unique() const
+		{
+			return _instance_block != nullptr && _instance_block->references == 1;
+		}
+
 		/** checks if story still exists */
 		inline bool is_story_valid() const { return _story_block != nullptr && _story_block->valid; }
 
@@ -155,6 +171,22 @@ public:
 		return story_ptr<U>(casted, *this);
 	}
 
+	/** gives up ownership, if this is the last pointer to the object. internal use only.
+	 * @private
+	 * @return the object, which the caller has to delete, or nullptr if other pointers to it exist,
+	 * then this pointer is left unchanged
+	 */
+	T* release_unique()
+	{
+		if (! is_valid() || ! story_ptr_base::is_unique()) {
+			return nullptr;
+		}
+		T* ptr = _ptr;
+		remove_reference();
+		_ptr = nullptr;
+		return ptr;
+	}
+
 	// == equality ==
 	/** implement operator== */
 	inline bool operator==(const story_ptr<T>& other) { return _ptr == other._ptr; }
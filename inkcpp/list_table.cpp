@@ -68,6 +68,7 @@ list_table::list_table(const char* data)
 
 list_table::list list_table::create()
 {
+	++_created;
 	for (size_t i = 0; i < _entry_state.size(); ++i) {
 		if (_entry_state[i] == state::empty) {
 			_entry_state[i] = state::used;
@@ -118,10 +119,13 @@ void list_table::mark_used(list l)
 	}
 }
 
-void list_table::gc()
+size_t list_table::gc()
 {
+	size_t freed = 0;
+	_created     = 0;
 	for (size_t i = 0; i < _entry_state.size(); ++i) {
 		if (_entry_state[i] == state::unused) {
+			++freed;
 			_entry_state[i] = state::empty;
 			data_t* entry   = getPtr(i);
 			for (int j = 0; j != _entrySize; ++j) {
@@ -129,7 +133,8 @@ void list_table::gc()
 			}
 		}
 	}
-	_list_handouts.clear();
+	release_handouts();
+	return freed;
 }
 
 size_t list_table::toFid(list_flag e) const { return listBegin(e.list_id) + e.flag; }
@@ -167,60 +172,21 @@ size_t list_table::stringLen(const list& l) const
 	return len;
 }
 
-/// @todo check ouput order for explicit valued lists
 /// @sa list_table::write()
 char* list_table::toString(char* out, const list& l) const
 {
-	char* itr = out;
-
-	const data_t* entry      = getPtr(l.lid);
-	int           last_value = 0;
-	int           last_list  = -1;
-	bool          first      = true;
-	int           min_value  = 0;
-	int           min_id     = -1;
-	int           min_list   = -1;
-
-	while (1) {
-		bool change = false;
-		for (size_t i = 0; i < numLists(); ++i) {
-			if (hasList(entry, i)) {
-				for (size_t j = listBegin(i); j < _list_end[i]; ++j) {
-					if (! hasFlag(entry, j)) {
-						continue;
-					}
-					int value = _flag_values[j];
-					// the cast is ok, since if we are in the
-					// first round, `first` is true and we do not evaluate
-					// second round, `last_list` is >= 0
-					if (first || value > last_value
-					    || (value == last_value && i > static_cast<size_t>(last_list))) {
-						if (min_id == -1 || value < min_value) {
-							change    = true;
-							min_list  = i;
-							min_value = value;
-							min_id    = j;
-						}
-						break;
-					}
-				}
-			}
-		}
-		if (! change) {
-			break;
-		}
+	char* itr   = out;
+	bool  first = true;
+	for_each_name(l, [&itr, &first](const char* name) {
 		if (! first) {
 			*itr++ = ',';
 			*itr++ = ' ';
 		}
 		first = false;
-		for (const char* c = _flag_names[min_id]; *c; ++c) {
+		for (const char* c = name; *c; ++c) {
 			*itr++ = *c;
 		}
-		last_value = min_value;
-		last_list  = min_list;
-		min_id     = -1;
-	}
+	});
 	return itr;
 }
 
@@ -813,51 +779,14 @@ list_interface* list_table::handout_list(list l)
 /// @sa list_table::toString(char*,const list&)
 std::ostream& list_table::write(std::ostream& os, list l) const
 {
-	const data_t* entry      = getPtr(l.lid);
-	int           last_value = 0;
-	int           last_list  = -1;
-	bool          first      = true;
-	int           min_value  = 0;
-	int           min_id     = -1;
-	int           min_list   = -1;
-
-	while (1) {
-		bool change = false;
-		for (size_t i = 0; i < numLists(); ++i) {
-			if (hasList(entry, static_cast<int>(i))) {
-				for (size_t j = listBegin(i); j < _list_end[i]; ++j) {
-					if (! hasFlag(entry, static_cast<int>(j))) {
-						continue;
-					}
-					int value = _flag_values[j];
-					// the cast is ok, since if we are in the
-					// first round, `first` is true and we do not evaluate
-					// second round, `last_list` is >= 0
-					if (first || value > last_value
-					    || (value == last_value && i > static_cast<size_t>(last_list))) {
-						if (min_id == -1 || value < min_value) {
-							min_value = value;
-							min_id    = j;
-							min_list  = i;
-							change    = true;
-						}
-						break;
-					}
-				}
-			}
-		}
-		if (! change) {
-			break;
-		}
+	bool first = true;
+	for_each_name(l, [&os, &first](const char* name) {
 		if (! first) {
 			os << ", ";
 		}
 		first = false;
-		os << _flag_names[min_id];
-		last_value = min_value;
-		last_list  = min_list;
-		min_id     = -1;
-	}
+		os << name;
+	});
 	return os;
 }
 #endif
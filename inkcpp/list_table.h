@@ -105,8 +105,18 @@ public:
 	/// mark list as used
 	void mark_used(list);
 
-	/// delete unused lists
-	void gc();
+	/// delete unused lists and release handed out lists
+	/// @return number of deleted lists
+	size_t gc();
+
+	/// invalidate lists handed out with get_var
+	void release_handouts() { _list_handouts.clear(); }
+
+	/// number of lists created since the last gc
+	size_t created() const { return _created; }
+
+	/// true if the next list would grow the table
+	bool nearly_full() const { return _entry_state.size() == _entry_state.capacity(); }
 
 
 	// function to setup list_table
@@ -136,6 +146,12 @@ public:
 	 */
 	char* toString(char* out, const list& l) const;
 
+	/** calls f(const char* name) for each flag in the list, in the order they are printed
+	 * @sa toString(char*, const list&)
+	 */
+	template<typename F>
+	void for_each_name(const list& l, F f) const;
+
 	/** Finds flag id to flag name
 	 * currently used a simple O(n) serach, for the expected number of flags should this be no problem
 	 * @param flag_name null terminated string contaning the flag name
@@ -388,7 +404,8 @@ private:
 	/// keep track over lists accessed with get_var, and clear then at gc time
 	managed_array<list_interface, config::limitEditableLists, true> _list_handouts;
 
-	bool _valid;
+	bool   _valid;
+	size_t _created = 0;
 
 public:
 	friend class named_flag_itr;
@@ -517,4 +534,52 @@ public:
 	std::ostream& write(std::ostream&, list) const;
 #endif
 };
+
+/// @todo check ouput order for explicit valued lists
+template<typename F>
+void list_table::for_each_name(const list& l, F f) const
+{
+	const data_t* entry      = getPtr(l.lid);
+	int           last_value = 0;
+	int           last_list  = -1;
+	bool          first      = true;
+	int           min_value  = 0;
+	int           min_id     = -1;
+	int           min_list   = -1;
+
+	while (1) {
+		bool change = false;
+		for (size_t i = 0; i < numLists(); ++i) {
+			if (hasList(entry, i)) {
+				for (size_t j = listBegin(i); j < _list_end[i]; ++j) {
+					if (! hasFlag(entry, j)) {
+						continue;
+					}
+					int value = _flag_values[j];
+					// the cast is ok, since if we are in the
+					// first round, `first` is true and we do not evaluate
+					// second round, `last_list` is >= 0
+					if (first || value > last_value
+					    || (value == last_value && i > static_cast<size_t>(last_list))) {
+						if (min_id == -1 || value < min_value) {
+							min_value = value;
+							min_id    = j;
+							min_list  = i;
+							change    = true;
+						}
+						break;
+					}
+				}
+			}
+		}
+		if (! change) {
+			break;
+		}
+		first = false;
+		f(_flag_names[min_id]);
+		last_value = min_value;
+		last_list  = min_list;
+		min_id     = -1;
+	}
+}
 } // namespace ink::runtime::internal
@@ -74,6 +74,12 @@ void basic_stream::append(const value& in)
 	}
 	_data[_size++] = in;
 
+	// Keep track of the innermost marker
+	if (in.type() == value_type::marker) {
+		_last_marker = _size - 1;
+		++_marker_count;
+	}
+
 	// Special: Incoming glue. Trim whitespace/newlines prior
 	//  This also applies when a function ends to trim trailing whitespace.
 	if ((in.type() == value_type::glue || in.type() == value_type::func_end) && _size > 1) {
@@ -160,39 +166,240 @@ void basic_stream::copy_string(const char* str, size_t&, T& output)
 	}
 }
 
-#ifdef INK_ENABLE_STL
-std::string basic_stream::get()
+namespace
 {
-	size_t start = find_start();
+	// Cleans up the whitespace of a text which is produced piece by piece. The result is the same
+	// as clean_string<true, false>() followed by dropping one trailing space. Every character is
+	// decided once the next one is known.
+	template<typename F>
+	class text_cleaner
+	{
+	public:
+		explicit text_cleaner(F& out)
+		    : _out{out}
+		{
+		}
 
-	// Move up from marker
-	bool              hasGlue = false, lastNewline = false;
-	std::stringstream str;
+		// source is the address of next in its string, or nullptr if next is a temporary
+		void put(char next, const char* source)
+		{
+			if (_current != 0) {
+				decide(next);
+			}
+			_previous       = _current;
+			_current        = next;
+			_current_source = source;
+		}
+
+		// str has to outlive the cleaner
+		void put(const char* str)
+		{
+			for (; *str; ++str) {
+				put(*str, str);
+			}
+		}
+
+		void put_temporary(const char* str)
+		{
+			while (*str) {
+				put(*str++, nullptr);
+			}
+		}
+
+		// returns the last kept character, including a dropped trailing space
+		char finish()
+		{
+			if (_current != 0) {
+				decide(0);
+			}
+			return _last;
+		}
+
+	private:
+		static bool space(char c) { return isspace(static_cast<unsigned char>(c)); }
+
+		void decide(char next)
+		{
+			const char c = _current;
+			if (_last == 0) {
+				if (space(c)) {
+					return;
+				}
+			} else if (_previous == '\n' && space(c)) {
+				return;
+			} else if (space(c) && c != '\n') {
+				if (next != 0 && space(next)) {
+					return;
+				}
+			} else if (c == '\n' && _last == '\n') {
+				return;
+			}
+
+			// a space is only written once something follows it
+			if (_last == ' ') {
+				_out(' ', _last_source);
+			}
+			if (c != ' ') {
+				_out(c, _current_source);
+			}
+			_last        = c;
+			_last_source = _current_source;
+		}
+
+		F&          _out;
+		char        _previous       = 0;
+		char        _current        = 0;
+		char        _last           = 0;
+		const char* _current_source = nullptr;
+		const char* _last_source    = nullptr;
+	};
+
+	// Groups the characters of a cleaned up text into spans. Characters which follow each other in
+	// the same string are passed on as one span pointing into it, temporaries are collected in a
+	// scratch buffer.
+	template<typename F>
+	class span_writer
+	{
+	public:
+		explicit span_writer(F& sink)
+		    : _sink{sink}
+		{
+		}
+
+		void operator()(char c, const char* source)
+		{
+			if (source != nullptr) {
+				if (_span != nullptr && _span + _length == source) {
+					++_length;
+					return;
+				}
+				flush();
+				_span   = source;
+				_length = 1;
+			} else {
+				if (_span != nullptr || _length == sizeof(_scratch)) {
+					flush();
+				}
+				_scratch[_length++] = c;
+			}
+		}
+
+		void flush()
+		{
+			if (_length > 0) {
+				_sink(_span != nullptr ? _span : _scratch, _length);
+			}
+			_span   = nullptr;
+			_length = 0;
+		}
+
+	private:
+		F&          _sink;
+		const char* _span   = nullptr;
+		size_t      _length = 0;
+		char        _scratch[32];
+	};
+} // namespace
+
+template<typename F>
+char basic_stream::write_text(size_t start, F&& out) const
+{
+	text_cleaner<std::remove_reference_t<F>> text{out};
+	bool                                     hasGlue = false, lastNewline = false;
 	for (size_t i = start; i < _size; i++) {
-		if (should_skip(i, hasGlue, lastNewline))
+		if (should_skip(i, hasGlue, lastNewline) || ! _data[i].printable()) {
 			continue;
-		if (_data[i].printable()) {
-			_data[i].write(str, _lists_table);
+		}
+		switch (_data[i].type()) {
+			case value_type::string: text.put(_data[i].get<value_type::string>()); break;
+			case value_type::newline: text.put('\n', nullptr); break;
+			case value_type::list_flag:
+				inkAssert(_lists_table, "to stringify lists, we need a list_table");
+				text.put(_lists_table->toString(_data[i].get<value_type::list_flag>()));
+				break;
+			case value_type::list: {
+				inkAssert(_lists_table, "to stringify lists, we need a list_table");
+				bool first = true;
+				_lists_table->for_each_name(
+				    _data[i].get<value_type::list>(),
+				    [&text, &first](const char* name) {
+					    if (! first) {
+						    text.put(", ");
+					    }
+					    first = false;
+					    text.put(name);
+				    }
+				);
+			} break;
+			default: {
+				char number[32];
+				toStr(number, sizeof(number), _data[i]);
+				text.put_temporary(number);
+			}
 		}
 	}
+	return text.finish();
+}
 
+void basic_stream::finish_get(size_t start, char last)
+{
 	// Reset stream size to where we last held the marker
-	_size = start;
+	truncate(start);
+	if (last != 0) {
+		_last_char = last;
+	}
+}
 
-	// Return processed string
-	// remove mulitple accourencies of ' '
-	std::string result = str.str();
-	if (! result.empty()) {
-		auto end = clean_string<true, false>(result.begin(), result.end());
-		if (result.begin() == end) {
-			result.resize(0);
-		} else {
-			_last_char = *(end - 1);
-			result.resize(end - result.begin() - (_last_char == ' ' ? 1 : 0));
+size_t basic_stream::get(char* buffer, size_t size)
+{
+	size_t start  = find_start();
+	size_t length = 0;
+	char   last   = write_text(start, [buffer, size, &length](char c, const char*) {
+		if (length + 1 < size) {
+			buffer[length] = c;
 		}
+		++length;
+	});
+
+	// keep the text if it does not fit
+	if (length >= size) {
+		return length;
 	}
+	buffer[length] = 0;
+	finish_get(start, last);
+	return length;
+}
+
+void basic_stream::get(void (*sink)(void*, const char*, size_t), void* context)
+{
+	size_t start = find_start();
+	auto   out   = [sink, context](const char* text, size_t length) {
+		sink(context, text, length);
+	};
+	span_writer<decltype(out)> spans{out};
+	char                       last = write_text(start, spans);
+	spans.flush();
+	finish_get(start, last);
+}
+
+#ifdef INK_ENABLE_STL
+std::string basic_stream::get()
+{
+	std::string result;
+	get(result);
 	return result;
 }
+
+void basic_stream::get(std::string& line)
+{
+	size_t start = find_start();
+	line.clear();
+	auto out = [&line](const char* text, size_t length) { line.append(text, length); };
+	span_writer<decltype(out)> spans{out};
+	char                       last = write_text(start, spans);
+	spans.flush();
+	finish_get(start, last);
+}
 #endif
 #ifdef INK_ENABLE_UNREAL
 FString basic_stream::get()
@@ -222,7 +429,7 @@ const value& basic_stream::peek() const
 void basic_stream::discard(size_t length)
 {
 	// Protect against size underflow
-	_size -= std::min(length, _size);
+	truncate(_size - std::min(length, _size));
 }
 
 void basic_stream::get(value* ptr, size_t length)
@@ -250,7 +457,7 @@ void basic_stream::get(value* ptr, size_t length)
 	}
 
 	// Reset stream size to where we last held the marker
-	_size = start;
+	truncate(start);
 }
 
 size_t basic_stream::find_first_of(value_type type, size_t offset /*= 0*/) const
@@ -306,7 +513,7 @@ void basic_stream::restore()
 	inkAssert(saved(), "No save point to restore!");
 
 	// Restore size to saved position
-	_size = _save;
+	truncate(_save);
 	_save = npos;
 }
 
@@ -386,7 +593,7 @@ char* basic_stream::get_alloc(string_table& strings, list_table& lists)
 	*ptr = 0;
 
 	// Reset stream size to where we last held the marker
-	_size = start;
+	truncate(start);
 
 	// Return processed string
 	end  = clean_string<RemoveTail, RemoveTail>(buffer, buffer + c_str_len(buffer));
@@ -403,12 +610,7 @@ char* basic_stream::get_alloc(string_table& strings, list_table& lists)
 size_t basic_stream::find_start() const
 {
 	// Find marker (or start)
-	size_t start = _size;
-	while (start > 0) {
-		start--;
-		if (_data[start].type() == value_type::marker)
-			break;
-	}
+	size_t start = has_marker() ? _last_marker : 0;
 
 	// Make sure we're not violating a save point
 	if (saved() && start < _save) {
@@ -421,6 +623,21 @@ size_t basic_stream::find_start() const
 	return start;
 }
 
+void basic_stream::truncate(size_t size)
+{
+	// Pop markers past the new end, the previous marker is searched backwards from the popped one
+	while (has_marker() && _last_marker >= size) {
+		if (--_marker_count == 0) {
+			_last_marker = npos;
+			break;
+		}
+		do {
+			--_last_marker;
+		} while (_data[_last_marker].type() != value_type::marker);
+	}
+	_size = size;
+}
+
 bool basic_stream::should_skip(size_t iter, bool& hasGlue, bool& lastNewline) const
 {
 	if (_data[iter].printable() && _data[iter].type() != value_type::newline
@@ -477,8 +694,10 @@ bool basic_stream::text_past_save() const
 
 void basic_stream::clear()
 {
-	_save = npos;
-	_size = 0;
+	_save         = npos;
+	_size         = 0;
+	_marker_count = 0;
+	_last_marker  = npos;
 }
 
 void basic_stream::mark_used(string_table& strings, list_table& lists) const
@@ -529,12 +748,28 @@ bool basic_stream::can_be_migrated() const
 	return true;
 }
 
+void basic_stream::copy_from(const basic_stream& other)
+{
+	if (other._size >= _max) {
+		overflow(_data, _max, other._size);
+	}
+	inkAssert(_max >= other._size, "output is to small to hold the copied data");
+	for (size_t i = 0; i < other._size; ++i) {
+		_data[i] = other._data[i];
+	}
+	_last_char    = other._last_char;
+	_size         = other._size;
+	_save         = other._save;
+	_marker_count = other._marker_count;
+	_last_marker  = other._last_marker;
+}
+
 size_t basic_stream::snap(unsigned char* data, const snapper& snapper) const
 {
 	unsigned char* ptr = data;
-	ptr                = snap_write(ptr, _last_char, data != nullptr);
-	ptr                = snap_write(ptr, _size, data != nullptr);
-	ptr                = snap_write(ptr, _save, data != nullptr);
+	ptr                = snap_write(ptr, _last_char, data != nullptr, snapper);
+	ptr                = snap_write(ptr, _size, data != nullptr, snapper);
+	ptr                = snap_write(ptr, _save, data != nullptr, snapper);
 	for (auto itr = _data; itr != _data + _size; ++itr) {
 		ptr += itr->snap(data ? ptr : nullptr, snapper);
 	}
@@ -543,15 +778,21 @@ size_t basic_stream::snap(unsigned char* data, const snapper& snapper) const
 
 const unsigned char* basic_stream::snap_load(const unsigned char* ptr, const loader& loader)
 {
-	ptr = snap_read(ptr, _last_char);
-	ptr = snap_read(ptr, _size);
-	ptr = snap_read(ptr, _save);
+	ptr = snap_read(ptr, _last_char, loader);
+	ptr = snap_read(ptr, _size, loader);
+	ptr = snap_read(ptr, _save, loader);
 	if (_size >= _max) {
 		overflow(_data, _max, _size);
 	}
 	inkAssert(_max >= _size, "output is to small to hold stored data");
+	_marker_count = 0;
+	_last_marker  = npos;
 	for (auto itr = _data; itr != _data + _size; ++itr) {
 		ptr = itr->snap_load(ptr, loader);
+		if (itr->type() == value_type::marker) {
+			_last_marker = static_cast<size_t>(itr - _data);
+			++_marker_count;
+		}
 	}
 	return ptr;
 }
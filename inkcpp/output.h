@@ -69,10 +69,27 @@ namespace runtime
 #ifdef INK_ENABLE_STL
 			// Extract into a string
 			std::string get();
+
+			// Extract into a string, reusing its storage
+			void get(std::string& line);
 #elif defined(INK_ENABLE_UNREAL)
 			FString get();
 #endif
 
+			/** Extract into a buffer, the text is cleaned up like by get() while it is copied
+			 * @param buffer destination, may be nullptr if size is 0
+			 * @param size capacity of buffer, including the terminating null
+			 * @return length of the text. If it is >= size the text did not fit and is kept in the
+			 * stream, the content of buffer is undefined then
+			 */
+			size_t get(char* buffer, size_t size);
+
+			/** Extract as spans, the text is cleaned up like by get()
+			 * @param sink called with context and each span of the text in order, spans point into
+			 * the strings of the stream or into a scratch buffer and are only valid during the call
+			 */
+			void get(void (*sink)(void*, const char*, size_t), void* context);
+
 			// Get filled size of output buffer
 			size_t filled() const { return _size; }
 
@@ -85,6 +102,9 @@ namespace runtime
 			// Checks if the output was saved
 			bool saved() const { return _save != npos; }
 
+			// Checks if the output contains a marker
+			bool has_marker() const { return _marker_count > 0; }
+
 			/** Find the first occurrence of the type in the output
 			 * @param type type to look for in the output
 			 * @param offset offset into buffer
@@ -124,6 +144,10 @@ namespace runtime
 			// add lists definitions, needed to print lists
 			void set_list_meta(const list_table& lists) { _lists_table = &lists; }
 
+			// replaces the content and the save point with the ones of other, the list definitions
+			// are kept
+			void copy_from(const basic_stream& other);
+
 			char last_char() const { return _last_char; }
 
 			// snapshot interface
@@ -133,8 +157,22 @@ namespace runtime
 
 		private:
 			size_t find_start() const;
+
+			// shrinks the stream to size and drops all markers past it
+			void truncate(size_t size);
+
 			bool   should_skip(size_t iter, bool& hasGlue, bool& lastNewline) const;
 
+			// Calls out(char, const char* source) for each character of the text from start with
+			// cleaned up whitespace. source points to the character in the string it was read from, or
+			// is nullptr if the character was formatted on the fly. Returns the last character before a
+			// trailing space is dropped, 0 if there is none
+			template<typename F>
+			char write_text(size_t start, F&& out) const;
+
+			// drops the extracted text from the stream and remembers its last character
+			void finish_get(size_t start, char last);
+
 			template<typename T>
 			void copy_string(const char* str, size_t& dataIter, T& output);
 
@@ -151,6 +189,10 @@ namespace runtime
 			// save point
 			size_t _save = npos;
 
+			// number of markers in the stream and position of the last one
+			size_t _marker_count = 0;
+			size_t _last_marker  = npos;
+
 			const list_table* _lists_table = nullptr;
 		};
 
@@ -10,6 +10,7 @@
 #include "command.h"
 #include "globals_impl.h"
 #include "header.h"
+#include "platform.h"
 #include "snapshot_impl.h"
 #include "story_impl.h"
 #include "system.h"
@@ -193,6 +194,103 @@ inline const char* runner_impl::read(optional<ip_t> pos)
 	return _story->string(str);
 }
 
+template<typename T>
+inline T runner_impl::operand() const
+{
+	static_assert(sizeof(T) == sizeof(uint32_t), "operands are 4 bytes long");
+	// copied, the operand may be a float stored in an integer
+	T result;
+	if constexpr (config::predecodeInstructions) {
+		memcpy(&result, &_inst->value, sizeof(T));
+	} else {
+		// fetch already stepped over the instruction
+		memcpy(&result, _ptr - sizeof(uint32_t), sizeof(T));
+	}
+	return result;
+}
+
+template<>
+inline const char* runner_impl::operand() const
+{
+	if constexpr (config::predecodeInstructions) {
+		return _inst->string;
+	} else {
+		return _story->string(operand<offset_t>());
+	}
+}
+
+inline ip_t runner_impl::operand_target() const
+{
+	if constexpr (config::predecodeInstructions) {
+		return _inst->target;
+	} else {
+		return _story->instructions() + operand<uint32_t>();
+	}
+}
+
+inline container_t runner_impl::operand_target_container() const
+{
+	if constexpr (config::predecodeInstructions) {
+		return _inst->container;
+	} else {
+		return _story->find_container_for(operand<uint32_t>());
+	}
+}
+
+inline container_t runner_impl::operand_start_container() const
+{
+	if constexpr (config::predecodeInstructions) {
+		return _inst->container;
+	} else {
+		container_t id;
+		return _story->find_container_id(operand<uint32_t>(), id) ? id : ~0U;
+	}
+}
+
+inline Command runner_impl::fused_command(int n) const
+{
+	if constexpr (config::predecodeInstructions) {
+		return _inst[n].command;
+	} else {
+		return static_cast<Command>(_ptr[(n - 1) * CommandSize<uint32_t>]);
+	}
+}
+
+inline CommandFlag runner_impl::fused_flag(int n) const
+{
+	if constexpr (config::predecodeInstructions) {
+		return _inst[n].flag;
+	} else {
+		return static_cast<CommandFlag>(_ptr[(n - 1) * CommandSize<uint32_t> + sizeof(Command)]);
+	}
+}
+
+template<typename T>
+inline T runner_impl::fused_operand(int n) const
+{
+	static_assert(sizeof(T) == sizeof(uint32_t), "operands are 4 bytes long");
+	T result;
+	if constexpr (config::predecodeInstructions) {
+		memcpy(&result, &_inst[n].value, sizeof(T));
+	} else {
+		memcpy(
+		    &result, _ptr + (n - 1) * CommandSize<uint32_t> + sizeof(Command) + sizeof(CommandFlag),
+		    sizeof(T)
+		);
+	}
+	return result;
+}
+
+template<>
+inline const char* runner_impl::fused_operand(int n) const
+{
+	if constexpr (config::predecodeInstructions) {
+		return _inst[n].string;
+	} else {
+		return _story->string(fused_operand<offset_t>(n));
+	}
+}
+
 choice& runner_impl::add_choice()
 {
 	inkAssert(
@@ -303,7 +401,7 @@ void runner_impl::fetch_tags(ip_t begin)
 	if (read<Command>(iter) == Command::START_CONTAINER_MARKER) {
 		iter += 6;
 	}
-	while (read<Command>(iter) == Command::START_TAG) {
+	while (unfused(read<Command>(iter)) == Command::START_TAG) {
 		// skip non-trivial tags (constant string only)
 		if (read<Command>(iter + 6) != Command::STR || read<Command>(iter + 12) != Command::END_TAG) {
 			while (read<Command>(iter) != Command::END_TAG) {
@@ -317,7 +415,9 @@ void runner_impl::fetch_tags(ip_t begin)
 	}
 }
 
-void runner_impl::jump(ip_t dest, bool record_visits, bool track_knot_visit)
+void runner_impl::jump(
+    ip_t dest, bool record_visits, bool track_knot_visit, container_t dest_hint /*= ~0U*/
+)
 {
 	// Optimization: if we are _is_falling, then we can
 	//  _should be_ able to safely assume that there is nothing to do here. A falling
@@ -341,7 +441,8 @@ void runner_impl::jump(ip_t dest, bool record_visits, bool track_knot_visit)
 
 	// Find the container at or before dest, which will become the top of the post-jump stack.
 	const uint32_t    dest_offset = dest - _story->instructions();
-	const container_t dest_id     = _story->find_container_for(dest_offset);
+	const container_t dest_id
+	    = dest_hint != ~0U ? dest_hint : _story->find_container_for(dest_offset);
 
 	// If there's no destination container, stop.
 	if (dest_id == ~0)
@@ -409,7 +510,7 @@ void runner_impl::jump(ip_t dest, bool record_visits, bool track_knot_visit)
 }
 
 template<frame_type type>
-void runner_impl::start_frame(uint32_t target)
+void runner_impl::start_frame(ip_t target, container_t target_container /*= ~0U*/)
 {
 	if constexpr (type == frame_type::function) {
 		// add a function start marker
@@ -424,8 +525,8 @@ void runner_impl::start_frame(uint32_t target)
 	_evaluation_mode = false; // unset eval mode when enter function or tunnel
 
 	// Do the jump
-	inkAssert(_story->instructions() + target < _story->end(), "Diverting past end of story data!");
-	jump(_story->instructions() + target, true, false);
+	inkAssert(target < _story->end(), "Diverting past end of story data!");
+	jump(target, true, false, target_container);
 }
 
 frame_type runner_impl::execute_return()
@@ -454,7 +555,9 @@ frame_type runner_impl::execute_return()
 		// the evaluation stack, we should follow this instead
 		// inkproof: I060
 		if (! _eval.is_empty() && _eval.top().type() == value_type::divert) {
-			start_frame<frame_type::tunnel>(_eval.pop().get<value_type::divert>());
+			start_frame<frame_type::tunnel>(
+			    _story->instructions() + _eval.pop().get<value_type::divert>()
+			);
 			return type;
 		}
 	}
@@ -491,8 +594,13 @@ runner_impl::runner_impl(const story_impl* data, globals global)
     , _rng()
 #endif
 {
+	attach();
+}
 
+runner_impl::~runner_impl() { detach(); }
 
+void runner_impl::attach()
+{
 	// register with globals
 	_globals->add_runner(this);
 	if (_globals->lists()) {
@@ -509,12 +617,109 @@ runner_impl::runner_impl(const story_impl* data, globals global)
 	}
 }
 
-runner_impl::~runner_impl()
+void runner_impl::detach()
 {
 	// unregister with globals
 	if (_globals.is_valid()) {
 		_globals->remove_runner(this);
 	}
+	_globals = nullptr;
+}
+
+bool runner_impl::has_own_globals() const { return _globals.is_valid() && ! _globals->is_shared(); }
+
+void runner_impl::recycle(globals global)
+{
+	inkAssert(! _globals.is_valid(), "Only detached runners can be recycled");
+	_globals = global.cast<globals_impl>();
+
+	// operations keep references to the string and list table of the globals
+	_operations.~executer();
+	new (&_operations) executer(
+	    _globals->strings(), _globals->lists(), _rng, *_globals, *_story,
+	    static_cast<const runner_interface&>(*this)
+	);
+
+	// drop all state, the containers keep their capacity
+	reset();
+	clear_tags(tags_clear_level::KEEP_NONE);
+	_fallback_choice = nullopt;
+	_functions.clear();
+	_ptr                    = _story->instructions();
+	_backup                 = nullptr;
+	_inst                   = nullptr;
+	_string_mode            = false;
+	_saved_evaluation_mode  = false;
+	_is_falling             = false;
+	_current_knot_id        = ~0U;
+	_current_knot_id_backup = ~0U;
+	_entered_knot           = false;
+	_entered_global         = false;
+#ifdef INK_ENABLE_STL
+	_debug_stream = nullptr;
+#endif
+
+	attach();
+}
+
+runner runner_impl::clone() const
+{
+	globals      store = story_ptr<globals_impl>(_globals).cast<globals_interface>();
+	runner_impl* copy  = new runner_impl(_story, store);
+
+	// Strings and lists belong to the shared globals, so values are copied as they are
+	copy->_ptr                    = _ptr;
+	copy->_backup                 = _backup;
+	copy->_done                   = _done;
+	copy->_inst                   = _inst;
+	copy->_rng                    = _rng;
+	copy->_evaluation_mode        = _evaluation_mode;
+	copy->_string_mode            = _string_mode;
+	copy->_saved_evaluation_mode  = _saved_evaluation_mode;
+	copy->_saved                  = _saved;
+	copy->_is_falling             = _is_falling;
+	copy->_ends_line              = _ends_line;
+	copy->_suspended              = _suspended;
+	copy->_resume_line            = _resume_line;
+	copy->_async_call             = _async_call;
+	copy->_line_pending           = _line_pending;
+	copy->_entered_global         = _entered_global;
+	copy->_entered_knot           = _entered_knot;
+	copy->_current_knot_id        = _current_knot_id;
+	copy->_current_knot_id_backup = _current_knot_id_backup;
+#ifdef INK_ENABLE_THREADED_DISPATCH
+	copy->_threaded_dispatch = _threaded_dispatch;
+#endif
+
+	copy->_output.copy_from(_output);
+	copy->_stack.copy_from(_stack);
+	copy->_ref_stack.copy_from(_ref_stack);
+	copy->_eval.copy_from(_eval);
+	copy->_tags_begin.copy_from(_tags_begin);
+	copy->_tags.copy_from(_tags);
+	copy->_container.copy_from(_container);
+	copy->_threads.copy_from(_threads);
+	copy->_choices.copy_from(_choices);
+	copy->_fallback_choice = _fallback_choice;
+
+	// choices point to their tags, move them to the tags of the copy
+	auto move_tags = [this, copy](snap_choice& c) {
+		if (c.has_tags()) {
+			c._tags_start = copy->_tags.data() + (c._tags_start - _tags.data());
+			c._tags_end   = copy->_tags.data() + (c._tags_end - _tags.data());
+		} else {
+			c._tags_start = nullptr;
+			c._tags_end   = nullptr;
+		}
+	};
+	for (snap_choice& c : copy->_choices) {
+		move_tags(c);
+	}
+	if (copy->_fallback_choice) {
+		move_tags(copy->_fallback_choice.value());
+	}
+
+	return _story->manage_runner(copy);
 }
 
 #if defined(INK_ENABLE_STL) || defined(INK_ENABLE_UNREAL)
@@ -522,7 +727,9 @@ runner_impl::~runner_impl()
 runner_impl::line_type runner_impl::getline()
 {
 	// Advance interpreter one line and write to output
-	advance_line();
+	if (! advance_line()) {
+		return line_type{};
+	}
 
 #	ifdef INK_ENABLE_STL
 	line_type result{_output.get()};
@@ -532,12 +739,7 @@ runner_impl::line_type runner_impl::getline()
 #		error unsupported constraints for getline
 #	endif
 
-	// Fall through the fallback choice, if available
-	if (! has_choices() && _fallback_choice) {
-		choose(~0U);
-	}
-	inkAssert(_output.is_empty(), "Output should be empty after getline!");
-
+	end_line();
 	return result;
 }
 
@@ -554,7 +756,7 @@ runner_impl::line_type runner_impl::getall()
 	while (can_continue()) {
 		result += getline();
 	}
-	inkAssert(_output.is_empty(), "Output should be empty after getall!");
+	inkAssert(_suspended || _output.is_empty(), "Output should be empty after getall!");
 
 	return result;
 }
@@ -562,7 +764,20 @@ runner_impl::line_type runner_impl::getall()
 #endif
 
 #ifdef INK_ENABLE_STL
-void runner_impl::getline(std::ostream& out) { out << getline(); }
+void runner_impl::getline(std::ostream& out)
+{
+	stream_line([&out](const char* text, size_t length) { out.write(text, length); });
+}
+
+void runner_impl::getline(std::string& line)
+{
+	if (! advance_line()) {
+		line.clear();
+		return;
+	}
+	_output.get(line);
+	end_line();
+}
 
 void runner_impl::getall(std::ostream& out)
 {
@@ -570,13 +785,24 @@ void runner_impl::getall(std::ostream& out)
 	while (can_continue()) {
 		out << getline();
 	}
-	inkAssert(_output.is_empty(), "Output should be empty after getall!");
+	inkAssert(_suspended || _output.is_empty(), "Output should be empty after getall!");
 }
 #endif
 
-void runner_impl::advance_line()
+bool runner_impl::advance_line()
 {
-	clear_tags(tags_clear_level::KEEP_KNOT);
+	// the line from the last getline is still waiting to be read
+	if (_line_pending) {
+		_line_pending = false;
+		return true;
+	}
+	inkAssert(! _suspended, "Runner is waiting for the result of an asynchronous function");
+
+	// the tags of an interrupted line are already collected
+	if (! _resume_line) {
+		clear_tags(tags_clear_level::KEEP_KNOT);
+	}
+	_resume_line = false;
 
 	// Step while we still have instructions to execute
 	while (_ptr != nullptr) {
@@ -584,6 +810,11 @@ void runner_impl::advance_line()
 		if (line_step()) {
 			break;
 		}
+		// Keep the state of the line until the result arrives
+		if (_suspended) {
+			_resume_line = true;
+			return false;
+		}
 	}
 
 	// can be in save state becaues of choice
@@ -591,16 +822,59 @@ void runner_impl::advance_line()
 	if (_saved) {
 		restore();
 	}
+	_globals->flush_observers();
 	_globals->gc();
 	if (_output.saved()) {
 		_output.restore();
 	}
+	return true;
+}
+
+void runner_impl::end_line()
+{
+	// Fall through the fallback choice, if available
+	if (! has_choices() && _fallback_choice) {
+		choose(~0U);
+	}
+	inkAssert(_output.is_empty(), "Output should be empty after getline!");
 }
 
-bool runner_impl::can_continue() const { return _ptr != nullptr && ! has_choices(); }
+bool runner_impl::can_continue() const
+{
+	return ! _suspended && (_line_pending || _resume_line || (_ptr != nullptr && ! has_choices()));
+}
+
+void runner_impl::resume_external(async_call token, ink::runtime::value result)
+{
+	inkAssert(
+	    _suspended && token == _async_call,
+	    "No asynchronous function call %u is waiting for a result", token
+	);
+	if (result.type == ink::runtime::value::Type::String) {
+		// the result may be temporary, keep a copy in the string table
+		const char* src    = result.get<ink::runtime::value::Type::String>();
+		char*       buffer = _globals->strings().create(string_handler<const char*>::length(src) + 1);
+		string_handler<const char*>::src_copy(src, buffer);
+		_eval.push(value{}.set<value_type::string>(buffer, true));
+	} else {
+		_eval.push(value(result));
+	}
+	_suspended = false;
+}
+
+void runner_impl::resume_external(async_call token)
+{
+	inkAssert(
+	    _suspended && token == _async_call,
+	    "No asynchronous function call %u is waiting for a result", token
+	);
+	_eval.push(values::null);
+	_suspended = false;
+}
 
 void runner_impl::choose(size_t index)
 {
+	inkAssert(! _suspended, "Runner is waiting for the result of an asynchronous function");
 	if (has_choices()) {
 		inkAssert(index < _choices.size(), "Choice index out of range");
 	} else if (! _fallback_choice) {
@@ -642,16 +916,22 @@ void runner_impl::choose(size_t index)
 
 void runner_impl::getline_silent()
 {
-	// advance and clear output stream
-	advance_line();
-	_output.clear();
+	// advance and clear output stream, an interrupted line is cleared once it is complete
+	if (advance_line()) {
+		_output.clear();
+	}
 }
 
 snapshot* runner_impl::create_snapshot() const { return _globals->create_snapshot(); }
 
+snapshot* runner_impl::create_delta_snapshot(const snapshot& base) const
+{
+	return _globals->create_delta_snapshot(base);
+}
+
 bool runner_impl::can_be_migrated() const
 {
-	if (_choices.size()) {
+	if (_choices.size() || _suspended || _resume_line) {
 		return false;
 	}
 	if (_entered_knot) {
@@ -685,17 +965,27 @@ size_t runner_impl::snap(unsigned char* data, snapper& snapper) const
 		hash_t container_hash = (container_id != ~0U) ? _story->container_data(container_id)._hash : 0;
 		ptr                   = snap_write(ptr, container_hash, should_write);
 	}
-	ptr    = snap_write(ptr, offset, should_write);
+	ptr    = snap_write(ptr, offset, should_write, snapper);
 	offset = _backup != nullptr ? _backup - _story->instructions() : 0;
-	ptr    = snap_write(ptr, offset, should_write);
+	ptr    = snap_write(ptr, offset, should_write, snapper);
 	offset = _done != nullptr ? _done - _story->instructions() : 0;
-	ptr    = snap_write(ptr, offset, should_write);
+	ptr    = snap_write(ptr, offset, should_write, snapper);
 	ptr    = snap_write(ptr, _rng.get_state(), should_write);
 	ptr    = snap_write(ptr, _evaluation_mode, should_write);
 	ptr    = snap_write(ptr, _string_mode, should_write);
 	ptr    = snap_write(ptr, _saved_evaluation_mode, should_write);
 	ptr    = snap_write(ptr, _saved, should_write);
 	ptr    = snap_write(ptr, _is_falling, should_write);
+	inkAssert(
+	    snapper.async_state || ! (_suspended || _resume_line || _line_pending),
+	    "Older snapshot versions can not store a pending asynchronous call or a pending line"
+	);
+	if (snapper.async_state) {
+		ptr = snap_write(ptr, _suspended, should_write);
+		ptr = snap_write(ptr, _resume_line, should_write);
+		ptr = snap_write(ptr, _async_call, should_write);
+		ptr = snap_write(ptr, _line_pending, should_write);
+	}
 	ptr += _output.snap(data ? ptr : nullptr, snapper);
 	ptr += _stack.snap(data ? ptr : nullptr, snapper);
 	ptr += _ref_stack.snap(data ? ptr : nullptr, snapper);
@@ -704,7 +994,7 @@ size_t runner_impl::snap(unsigned char* data, snapper& snapper) const
 	ptr += _tags.snap(data ? ptr : nullptr, snapper);
 	snapper.runner_tags = _tags.data();
 	ptr                 = snap_write(ptr, _entered_global, should_write);
-	ptr                 = snap_write(ptr, _entered_knot, should_write);
+	ptr                 = snap_write(ptr, _entered_knot, should_write, snapper);
 	ptr                 = snap_write(ptr, get_current_knot(), should_write);
 	if (_current_knot_id_backup != ~0U) {
 		ptr = snap_write(ptr, _story->container_data(_current_knot_id_backup)._hash, should_write);
@@ -729,11 +1019,11 @@ const unsigned char* runner_impl::snap_load(const unsigned char* data, loader& l
 	hash_t         current_knot_name;
 	// TODO: remove
 	ptr     = snap_read(ptr, current_knot_name);
-	ptr     = snap_read(ptr, offset);
+	ptr     = snap_read(ptr, offset, loader);
 	_ptr    = offset == 0 ? nullptr : _story->instructions() + offset;
-	ptr     = snap_read(ptr, offset);
+	ptr     = snap_read(ptr, offset, loader);
 	_backup = offset == 0 ? nullptr : _story->instructions() + offset;
-	ptr     = snap_read(ptr, offset);
+	ptr     = snap_read(ptr, offset, loader);
 	_done   = offset == 0 ? nullptr : _story->instructions() + offset;
 	int32_t seed;
 	ptr = snap_read(ptr, seed);
@@ -743,6 +1033,17 @@ const unsigned char* runner_impl::snap_load(const unsigned char* data, loader& l
 	ptr                = snap_read(ptr, _saved_evaluation_mode);
 	ptr                = snap_read(ptr, _saved);
 	ptr                = snap_read(ptr, _is_falling);
+	if (loader.async_state) {
+		ptr = snap_read(ptr, _suspended);
+		ptr = snap_read(ptr, _resume_line);
+		ptr = snap_read(ptr, _async_call);
+		ptr = snap_read(ptr, _line_pending);
+	} else {
+		_suspended    = false;
+		_resume_line  = false;
+		_async_call   = 0;
+		_line_pending = false;
+	}
 	ptr                = _output.snap_load(ptr, loader);
 	ptr                = _stack.snap_load(ptr, loader);
 	ptr                = _ref_stack.snap_load(ptr, loader);
@@ -751,7 +1052,7 @@ const unsigned char* runner_impl::snap_load(const unsigned char* data, loader& l
 	ptr                = _tags.snap_load(ptr, loader);
 	loader.runner_tags = _tags.data();
 	ptr                = snap_read(ptr, _entered_global);
-	ptr                = snap_read(ptr, _entered_knot);
+	ptr                = snap_read(ptr, _entered_knot, loader);
 	_current_knot_id   = ~0U;
 	ptr                = snap_read(ptr, current_knot_name);
 	if (current_knot_name) {
@@ -788,15 +1089,41 @@ const unsigned char* runner_impl::snap_load(const unsigned char* data, loader& l
 
 const char* runner_impl::getline_alloc()
 {
-	advance_line();
-	const char* res = _output.get_alloc(_globals->strings(), _globals->lists());
-	if (! has_choices() && _fallback_choice) {
-		choose(~0U);
+	if (! advance_line()) {
+		return "";
 	}
-	inkAssert(_output.is_empty(), "Output should be empty after getline!");
+	const char* res = _output.get_alloc(_globals->strings(), _globals->lists());
+	end_line();
 	return res;
 }
 
+size_t runner_impl::getline(char* buffer, size_t size)
+{
+	if (! advance_line()) {
+		if (size > 0) {
+			buffer[0] = 0;
+		}
+		return 0;
+	}
+	size_t length = _output.get(buffer, size);
+	if (length >= size) {
+		// keep the line until it is read with a large enough buffer
+		_line_pending = true;
+		return length;
+	}
+	end_line();
+	return length;
+}
+
+void runner_impl::stream_line(line_sink sink, void* context)
+{
+	if (! advance_line()) {
+		return;
+	}
+	_output.get(sink, context);
+	end_line();
+}
+
 bool runner_impl::move_to(hash_t path)
 {
 	// find the path
@@ -837,7 +1164,7 @@ bool runner_impl::migrate_to(hash_t path)
 						    read<Command>(eval_start) == Command::END_EVAL,
 						    "expected an evaluation segment before defininng a temporary variable"
 						);
-						while (read<Command>(eval_start) != Command::START_EVAL) {
+						while (unfused(read<Command>(eval_start)) != Command::START_EVAL) {
 							eval_start -= 6;
 						}
 						jump(eval_start, false, false);
@@ -901,9 +1228,17 @@ bool runner_impl::line_step()
 	// Step the interpreter
 	// Copy global tags to the first line
 	size_t o_size = _output.filled();
+	_ends_line    = false;
+#ifdef INK_ENABLE_THREADED_DISPATCH
+	if (_threaded_dispatch) {
+		step_run();
+	} else {
+		step();
+	}
+#else
 	step();
-	if ((o_size < _output.filled() && _output.find_first_of(value_type::marker) == _output.npos
-	     && ! _evaluation_mode && ! _saved)
+#endif
+	if ((o_size < _output.filled() && ! _output.has_marker() && ! _evaluation_mode && ! _saved)
 	    || (_entered_knot && _entered_global)) {
 		if (_entered_global) {
 			assign_tags({tags_level::LINE, tags_level::GLOBAL});
@@ -927,7 +1262,7 @@ bool runner_impl::line_step()
 	}
 
 	// If we're not within string evaluation
-	if (_output.find_first_of(value_type::marker) == _output.npos) {
+	if (! _output.has_marker()) {
 
 		// Haven't added more text
 
@@ -962,6 +1297,10 @@ bool runner_impl::line_step()
 				// can return here if we end up hitting a new line
 				if (! _saved) {
 					assign_tags({tags_level::LINE});
+					// The compiler knows the next content is text, which would be restored anyway
+					if (_ends_line && ! has_choices() && ! _fallback_choice) {
+						return true;
+					}
 					save();
 				}
 			}
@@ -980,57 +1319,240 @@ bool runner_impl::line_step()
 
 void runner_impl::step()
 {
-#ifdef INK_ENABLE_EXCEPTIONS
-	try
+#ifdef INK_ENABLE_STL
+	if (_debug_stream != nullptr) {
+		execute<true, false>();
+		return;
+	}
 #endif
-	{
-		inkAssert(_ptr != nullptr, "Can not step! Do not have a valid pointer");
+	execute<false, false>();
+}
 
-		// Load current command
-		Command     cmd  = read<Command>();
-		CommandFlag flag = read<CommandFlag>();
+#ifdef INK_ENABLE_THREADED_DISPATCH
+void runner_impl::step_run()
+{
+#	ifdef INK_ENABLE_STL
+	if (_debug_stream != nullptr) {
+		execute<true, true>();
+		return;
+	}
+#	endif
+	execute<false, true>();
+}
+#endif
+
+template<bool Traced>
+inline void runner_impl::fetch(Command& cmd, CommandFlag& flag)
+{
+	inkAssert(_ptr != nullptr, "Can not step! Do not have a valid pointer");
+
+	// Load current command, the operand is accessed with operand()
+	if constexpr (config::predecodeInstructions) {
+		_inst = &_story->decoded(_ptr);
+		cmd   = _inst->command;
+		flag  = _inst->flag;
+		_ptr += CommandSize<uint32_t>;
+	} else {
+		cmd  = read<Command>();
+		flag = read<CommandFlag>();
+		read<uint32_t>();
+	}
+	inkAssert(cmd < Command::NUM_COMMANDS, "Unrecognized command!");
 
 #ifdef INK_ENABLE_STL
-		if (_debug_stream != nullptr) {
-			*_debug_stream << "cmd " << cmd << " flags " << flag << " ";
-		}
+	if constexpr (Traced) {
+		*_debug_stream << "cmd " << cmd << " flags " << flag << " ";
+	}
 #endif
 
-		// If we're falling and we hit a non-fallthrough command, stop the fall.
-		if (_is_falling
-		    && ! (
-		        (cmd == Command::DIVERT && flag & CommandFlag::DIVERT_IS_FALLTHROUGH)
-		        || cmd == Command::END_CONTAINER_MARKER
-		    )) {
-			_is_falling = false;
-			set_done_ptr(nullptr);
-		}
-		if (cmd >= Command::OP_BEGIN && cmd < Command::OP_END) {
-			read<uint32_t>();
-			_operations(cmd, _eval);
-		} else {
+	// If we're falling and we hit a non-fallthrough command, stop the fall.
+	if (_is_falling
+	    && ! (
+	        (cmd == Command::DIVERT && flag & CommandFlag::DIVERT_IS_FALLTHROUGH)
+	        || cmd == Command::END_CONTAINER_MARKER
+	    )) {
+		_is_falling = false;
+		set_done_ptr(nullptr);
+	}
+}
+
+template<bool Traced>
+inline void runner_impl::trace_end()
+{
+#ifdef INK_ENABLE_STL
+	if constexpr (Traced) {
+		*_debug_stream << std::endl;
+	}
+#endif
+}
+
+// Handler labels. Every handler is a case of the dispatch switch, with computed goto it is
+// additionally a label, which is entered directly through the dispatch table.
+#ifdef INK_ENABLE_COMPUTED_GOTO
+#	define INK_OPCODE(cmd) \
+		case Command::cmd:   \
+		op_##cmd
+#	define INK_DISPATCH()         \
+		fetch<Traced>(cmd, flag); \
+		goto* dispatch_table[static_cast<std::underlying_type_t<Command>>(cmd)]
+#else
+#	define INK_OPCODE(cmd) case Command::cmd
+#	define INK_DISPATCH()  continue
+#endif
+
+// Ends a handler which can not influence the line state evaluated by line_step()
+// (no output, tags, choices or control flow). When executing a run the next instruction is
+// dispatched right away, else the step ends here.
+#define INK_NEXT         \
+	if constexpr (Run) {   \
+		trace_end<Traced>(); \
+		INK_DISPATCH();      \
+	}                      \
+	break
+
+#if defined(INK_ENABLE_COMPUTED_GOTO) && defined(__GNUC__)
+// labels as values are a compiler extension
+#	pragma GCC diagnostic push
+#	pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+template<bool Traced, bool Run>
+void runner_impl::execute()
+{
+#ifdef INK_ENABLE_COMPUTED_GOTO
+	// handler for each command, in order of the Command enum
+	static const void* const dispatch_table[] = {
+	    &&op_STR,
+	    &&op_INT,
+	    &&op_BOOL,
+	    &&op_FLOAT,
+	    &&op_VALUE_POINTER,
+	    &&op_DIVERT_VAL,
+	    &&op_LIST,
+	    &&op_NEWLINE,
+	    &&op_GLUE,
+	    &&op_VOID,
+	    &&op_TAG,
+	    &&op_DIVERT,
+	    &&op_DIVERT_TO_VARIABLE,
+	    &&op_TUNNEL,
+	    &&op_FUNCTION,
+	    &&op_DONE,
+	    &&op_END,
+	    &&op_TUNNEL_RETURN,
+	    &&op_FUNCTION_RETURN,
+	    &&op_DEFINE_TEMP,
+	    &&op_SET_VARIABLE,
+	    &&op_START_EVAL,
+	    &&op_END_EVAL,
+	    &&op_OUTPUT,
+	    &&op_POP,
+	    &&op_DUPLICATE,
+	    &&op_PUSH_VARIABLE_VALUE,
+	    &&op_VISIT,
+	    &&op_TURN,
+	    &&op_READ_COUNT,
+	    &&op_SEQUENCE,
+	    &&op_SEED,
+	    &&op_START_STR,
+	    &&op_END_STR,
+	    &&op_START_TAG,
+	    &&op_END_TAG,
+	    &&op_CHOICE,
+	    &&op_THREAD,
+	    // LIST_RANGE .. CHOICE_COUNT
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_OPERATION,
+	    &&op_START_CONTAINER_MARKER,
+	    &&op_END_CONTAINER_MARKER,
+	    &&op_CALL_EXTERNAL,
+	    &&op_EVAL_STR,
+	    &&op_EVAL_VARIABLE_OP_INT,
+	    &&op_TAG_STR,
+	    &&op_STR_NEWLINE,
+	};
+	static_assert(
+	    static_cast<int>(Command::OP_END) - static_cast<int>(Command::OP_BEGIN) == 37,
+	    "operation commands changed, update the dispatch table"
+	);
+	static_assert(
+	    sizeof(dispatch_table) / sizeof(*dispatch_table)
+	        == static_cast<size_t>(Command::NUM_COMMANDS),
+	    "dispatch table must contain a handler for each command"
+	);
+#endif
+
+#ifdef INK_ENABLE_EXCEPTIONS
+	try
+#endif
+	{
+		Command     cmd;
+		CommandFlag flag;
+		for (;;) {
+			fetch<Traced>(cmd, flag);
+#ifdef INK_ENABLE_COMPUTED_GOTO
+			// a single step is dispatched through the switch, like without threaded dispatch
+			if constexpr (Run) {
+				goto* dispatch_table[static_cast<std::underlying_type_t<Command>>(cmd)];
+			}
+#endif
 			switch (cmd) {
 					// == Value Commands ==
-				case Command::STR: {
-					const char* str = read<const char*>();
+				INK_OPCODE(STR): {
+					const char* str = operand<const char*>();
 
 #ifdef INK_ENABLE_STL
-					if (_debug_stream != nullptr) {
+					if constexpr (Traced) {
 						*_debug_stream << "str \"" << str << "\"";
 					}
 #endif
 
 					if (_evaluation_mode) {
-						_eval.push(value{}.set<value_type::string>(str));
+						_eval.push(value{}.set<value_type::string>(str, false));
+						INK_NEXT;
 					} else {
-						_output << value{}.set<value_type::string>(str);
+						_output << value{}.set<value_type::string>(str, false);
 					}
 				} break;
-				case Command::INT: {
-					int val = read<int>();
+				INK_OPCODE(INT): {
+					int val = operand<int>();
 
 #ifdef INK_ENABLE_STL
-					if (_debug_stream != nullptr) {
+					if constexpr (Traced) {
 						*_debug_stream << "int " << val;
 					}
 #endif
@@ -1039,27 +1561,28 @@ void runner_impl::step()
 						_eval.push(value{}.set<value_type::int32>(static_cast<int32_t>(val)));
 					}
 					// TEST-CASE B006 don't print integers
-				} break;
-				case Command::BOOL: {
-					bool val = read<int>() ? true : false;
+				} INK_NEXT;
+				INK_OPCODE(BOOL): {
+					bool val = operand<int>() ? true : false;
 
 #ifdef INK_ENABLE_STL
-					if (_debug_stream != nullptr) {
+					if constexpr (Traced) {
 						*_debug_stream << "bool " << (val ? "true" : "false");
 					}
 #endif
 
 					if (_evaluation_mode) {
 						_eval.push(value{}.set<value_type::boolean>(val));
+						INK_NEXT;
 					} else {
 						_output << value{}.set<value_type::boolean>(val);
 					}
 				} break;
-				case Command::FLOAT: {
-					float val = read<float>();
+				INK_OPCODE(FLOAT): {
+					float val = operand<float>();
 
 #ifdef INK_ENABLE_STL
-					if (_debug_stream != nullptr) {
+					if constexpr (Traced) {
 						*_debug_stream << "float " << val;
 					}
 #endif
@@ -1068,12 +1591,12 @@ void runner_impl::step()
 						_eval.push(value{}.set<value_type::float32>(val));
 					}
 					// TEST-CASE B006 don't print floats
-				} break;
-				case Command::VALUE_POINTER: {
-					hash_t val = read<hash_t>();
+				} INK_NEXT;
+				INK_OPCODE(VALUE_POINTER): {
+					hash_t val = operand<hash_t>();
 
 #ifdef INK_ENABLE_STL
-					if (_debug_stream != nullptr) {
+					if constexpr (Traced) {
 						*_debug_stream << "value_pointer ";
 						write_hash(*_debug_stream, val);
 					}
@@ -1084,70 +1607,71 @@ void runner_impl::step()
 					} else {
 						inkFail("never conciderd what should happend here! (value pointer print)");
 					}
-				} break;
-				case Command::LIST: {
-					list_table::list list(read<int>());
+				} INK_NEXT;
+				INK_OPCODE(LIST): {
+					list_table::list list(operand<int>());
 
 #ifdef INK_ENABLE_STL
-					if (_debug_stream != nullptr) {
+					if constexpr (Traced) {
 						*_debug_stream << "list " << list.lid;
 					}
 #endif
 
 					if (_evaluation_mode) {
 						_eval.push(value{}.set<value_type::list>(list));
+						INK_NEXT;
 					} else {
 						char* str = _globals->strings().create(_globals->lists().stringLen(list) + 1);
 						_globals->lists().toString(str, list)[0] = 0;
 						_output << value{}.set<value_type::string>(str);
 					}
 				} break;
-				case Command::DIVERT_VAL: {
+				INK_OPCODE(DIVERT_VAL): {
 					inkAssert(_evaluation_mode, "Can not push divert value into the output stream!");
 
 					// Push the divert target onto the stack
-					uint32_t target = read<uint32_t>();
+					uint32_t target = operand<uint32_t>();
 					_eval.push(value{}.set<value_type::divert>(target));
-				} break;
-				case Command::NEWLINE: {
-					read<uint32_t>();
+				} INK_NEXT;
+				INK_OPCODE(NEWLINE): {
 					if (_evaluation_mode) {
 						_eval.push(values::newline);
+						INK_NEXT;
 					} else {
 						if (! _output.ends_with(value_type::newline)) {
 							_output << values::newline;
+							_ends_line = flag & CommandFlag::NEWLINE_ENDS_LINE;
 						}
 					}
 				} break;
-				case Command::GLUE: {
-					read<uint32_t>();
+				INK_OPCODE(GLUE): {
 					if (_evaluation_mode) {
 						_eval.push(values::glue);
+						INK_NEXT;
 					} else {
 						_output << values::glue;
 					}
 				} break;
-				case Command::VOID: {
-					read<uint32_t>();
+				INK_OPCODE(VOID): {
 					if (_evaluation_mode) {
 						_eval.push(values::null); // TODO: void type?
 					}
-				} break;
+				} INK_NEXT;
 
 				// == Divert commands
-				case Command::DIVERT: {
+				INK_OPCODE(DIVERT): {
 					// Find divert address
-					uint32_t target = read<uint32_t>();
+					ip_t target = operand_target();
 
 #ifdef INK_ENABLE_STL
-					if (_debug_stream != nullptr) {
-						*_debug_stream << "target " << target;
+					if constexpr (Traced) {
+						*_debug_stream << "target " << target - _story->instructions();
 					}
 #endif
 
 					// Check for condition
 					if (flag & CommandFlag::DIVERT_HAS_CONDITION && ! _eval.pop().truthy(_globals->lists())) {
-						break;
+						INK_NEXT;
 					}
 
 					// SPECIAL: Fallthrough divert. We're starting to fall out of containers
@@ -1165,7 +1689,7 @@ void runner_impl::step()
 					}
 
 					// If we're falling out of the story, then we're hitting an implied done
-					if (_is_falling && _story->instructions() + target == _story->end()) {
+					if (_is_falling && target == _story->end()) {
 						// Wait! We may be returning from a function!
 						frame_type type;
 						if (_stack.has_frame(&type)
@@ -1184,17 +1708,17 @@ void runner_impl::step()
 					}
 
 					// Do the jump
-					inkAssert(
-					    _story->instructions() + target < _story->end(), "Diverting past end of story data!"
+					inkAssert(target < _story->end(), "Diverting past end of story data!");
+					jump(
+					    target, true, ! (flag & CommandFlag::DIVERT_HAS_CONDITION), operand_target_container()
 					);
-					jump(_story->instructions() + target, true, ! (flag & CommandFlag::DIVERT_HAS_CONDITION));
 				} break;
-				case Command::DIVERT_TO_VARIABLE: {
+				INK_OPCODE(DIVERT_TO_VARIABLE): {
 					// Get variable value
-					hash_t variable = read<hash_t>();
+					hash_t variable = operand<hash_t>();
 
 #ifdef INK_ENABLE_STL
-					if (_debug_stream != nullptr) {
+					if constexpr (Traced) {
 						*_debug_stream << "variable ";
 						write_hash(*_debug_stream, variable);
 					}
@@ -1202,7 +1726,7 @@ void runner_impl::step()
 
 					// Check for condition
 					if (flag & CommandFlag::DIVERT_HAS_CONDITION && ! _eval.pop().truthy(_globals->lists())) {
-						break;
+						INK_NEXT;
 					}
 
 					const value* val = get_var(variable);
@@ -1217,77 +1741,77 @@ void runner_impl::step()
 				} break;
 
 				// == Terminal commands
-				case Command::DONE:
-					read<uint32_t>();
+				INK_OPCODE(DONE):
 					on_done(true);
 					break;
 
-				case Command::END:
-					read<uint32_t>();
+				INK_OPCODE(END):
 					_ptr = nullptr;
 					break;
 
 				// == Tunneling
-				case Command::TUNNEL: {
-					uint32_t target;
+				INK_OPCODE(TUNNEL): {
+					ip_t        target;
+					container_t target_container = ~0U;
 					// Find divert address
 					if (flag & CommandFlag::TUNNEL_TO_VARIABLE) {
-						hash_t       var_name = read<hash_t>();
+						hash_t       var_name = operand<hash_t>();
 						const value* val      = get_var(var_name);
 						inkAssert(val != nullptr, "Variable containing tunnel target could not be found!");
-						target = val->get<value_type::divert>();
+						target = _story->instructions() + val->get<value_type::divert>();
 					} else {
-						target = read<uint32_t>();
+						target           = operand_target();
+						target_container = operand_target_container();
 					}
 
 #ifdef INK_ENABLE_STL
-					if (_debug_stream != nullptr) {
-						*_debug_stream << "target " << target;
+					if constexpr (Traced) {
+						*_debug_stream << "target " << target - _story->instructions();
 					}
 #endif
 
-					start_frame<frame_type::tunnel>(target);
+					start_frame<frame_type::tunnel>(target, target_container);
 				} break;
-				case Command::FUNCTION: {
-					uint32_t target;
+				INK_OPCODE(FUNCTION): {
+					ip_t        target;
+					container_t target_container = ~0U;
 					// Find divert address
 					if (flag & CommandFlag::FUNCTION_TO_VARIABLE) {
-						hash_t       var_name = read<hash_t>();
+						hash_t       var_name = operand<hash_t>();
 						const value* val      = get_var(var_name);
 						inkAssert(val != nullptr, "Varibale containing function could not be found!");
-						target = val->get<value_type::divert>();
+						target = _story->instructions() + val->get<value_type::divert>();
 					} else {
-						target = read<uint32_t>();
+						target           = operand_target();
+						target_container = operand_target_container();
 					}
 
 #ifdef INK_ENABLE_STL
-					if (_debug_stream != nullptr) {
-						*_debug_stream << "target " << target;
+					if constexpr (Traced) {
+						*_debug_stream << "target " << target - _story->instructions();
 					}
 #endif
 
 					if (! (flag & CommandFlag::FALLBACK_FUNCTION)) {
-						start_frame<frame_type::function>(target);
+						start_frame<frame_type::function>(target, target_container);
 					} else {
 						inkAssert(! _eval.is_empty(), "fallback function but no function call before?");
 						if (_eval.top_value().type() == value_type::ex_fn_not_found) {
 							_eval.pop();
 							inkAssert(
-							    target != 0,
+							    target != _story->instructions(),
 							    "Exetrnal function was not binded, and no fallback function provided!"
 							);
-							start_frame<frame_type::function>(target);
+							start_frame<frame_type::function>(target, target_container);
 						}
 					}
 				} break;
-				case Command::TUNNEL_RETURN:
-				case Command::FUNCTION_RETURN: {
-					read<uint32_t>();
+				INK_OPCODE(TUNNEL_RETURN):
+				INK_OPCODE(FUNCTION_RETURN): {
 					execute_return();
 				} break;
 
-				case Command::THREAD: {
-					read<uint32_t>();
+				INK_OPCODE(THREAD): {
 					// Push a thread frame so we can return easily
 					// TODO We push ahead of a single divert. Is that correct in all cases....?????
 					auto returnTo = _ptr + CommandSize<uint32_t>;
@@ -1306,7 +1830,7 @@ void runner_impl::step()
 					}
 
 #ifdef INK_ENABLE_STL
-					if (_debug_stream != nullptr) {
+					if constexpr (Traced) {
 						*_debug_stream << "thread " << thread;
 					}
 #endif
@@ -1316,12 +1840,12 @@ void runner_impl::step()
 				} break;
 
 				// == set temporärie variable
-				case Command::DEFINE_TEMP: {
-					hash_t variableName = read<hash_t>();
+				INK_OPCODE(DEFINE_TEMP): {
+					hash_t variableName = operand<hash_t>();
 					bool   is_redef     = flag & CommandFlag::ASSIGNMENT_IS_REDEFINE;
 
 #ifdef INK_ENABLE_STL
-					if (_debug_stream != nullptr) {
+					if constexpr (Traced) {
 						*_debug_stream << "variable_name ";
 						write_hash(*_debug_stream, variableName);
 						*_debug_stream << " is_redef " << (is_redef ? "yes" : "no");
@@ -1331,10 +1855,10 @@ void runner_impl::step()
 					// Get the top value and put it into the variable
 					value v = _eval.pop();
 					set_var<Scope::LOCAL>(variableName, v, is_redef);
-				} break;
+				} INK_NEXT;
 
-				case Command::SET_VARIABLE: {
-					hash_t variableName = read<hash_t>();
+				INK_OPCODE(SET_VARIABLE): {
+					hash_t variableName = operand<hash_t>();
 
 					// Check if it's a redefinition (not yet used, seems important for pointers later?)
 					bool is_redef = flag & CommandFlag::ASSIGNMENT_IS_REDEFINE;
@@ -1344,7 +1868,7 @@ void runner_impl::step()
 					value val = _eval.pop();
 
 #ifdef INK_ENABLE_STL
-					if (_debug_stream != nullptr) {
+					if constexpr (Traced) {
 						*_debug_stream << "variable_name ";
 						write_hash(*_debug_stream, variableName);
 						*_debug_stream << " is_redef " << (is_redef ? "yes" : "no");
@@ -1356,18 +1880,18 @@ void runner_impl::step()
 					} else {
 						set_var<Scope::GLOBAL>(variableName, val, is_redef);
 					}
-				} break;
+				} INK_NEXT;
 
 				// == Function calls
-				case Command::CALL_EXTERNAL: {
+				INK_OPCODE(CALL_EXTERNAL): {
 					// Read function name
-					hash_t functionName = read<hash_t>();
+					hash_t functionName = operand<hash_t>();
 
 					// Interpret flag as argument count
 					int numArguments = static_cast<int>(flag);
 
 #ifdef INK_ENABLE_STL
-					if (_debug_stream != nullptr) {
+					if constexpr (Traced) {
 						*_debug_stream << "function_name ";
 						write_hash(*_debug_stream, functionName);
 						*_debug_stream << " numArguments " << numArguments;
@@ -1376,6 +1900,13 @@ void runner_impl::step()
 
 					// find and execute. will automatically push a valid if applicable
 					auto* fn = _functions.find(functionName);
+					if (fn == nullptr) {
+						// resolve functions shared through the story once, later calls find them here
+						fn = _story->shared_functions().find(functionName);
+						if (fn != nullptr) {
+							_functions.cache(functionName, fn);
+						}
+					}
 					if (fn == nullptr) {
 						_eval.push(values::ex_fn_not_found);
 					} else if (_output.saved()
@@ -1383,42 +1914,41 @@ void runner_impl::step()
 					           && ! fn->lookaheadSafe()) {
 						// TODO: seperate token?
 						_output.append(values::null);
+					} else if (fn->async()) {
+						// suspend until the result arrives, unless the function delivers it right away
+						_suspended = true;
+						fn->call_async(&_eval, numArguments, _globals->lists(), ++_async_call);
 					} else {
 						fn->call(&_eval, numArguments, _globals->strings(), _globals->lists());
 					}
 				} break;
 
 				// == Evaluation stack
-				case Command::START_EVAL:
-					read<uint32_t>();
+				INK_OPCODE(START_EVAL):
 					_evaluation_mode = true;
-					break;
-				case Command::END_EVAL:
-					read<uint32_t>();
+					INK_NEXT;
+				INK_OPCODE(END_EVAL):
 					_evaluation_mode = false;
 
 					// Assert stack is empty? Is that necessary?
-					break;
-				case Command::OUTPUT: {
-					read<uint32_t>();
+					INK_NEXT;
+				INK_OPCODE(OUTPUT): {
 					value v = _eval.pop();
 					_output << v;
 				} break;
-				case Command::POP:
-					read<uint32_t>();
+				INK_OPCODE(POP):
 					_eval.pop();
-					break;
-				case Command::DUPLICATE:
-					read<uint32_t>();
+					INK_NEXT;
+				INK_OPCODE(DUPLICATE):
 					_eval.push(_eval.top_value());
-					break;
-				case Command::PUSH_VARIABLE_VALUE: {
+					INK_NEXT;
+				INK_OPCODE(PUSH_VARIABLE_VALUE): {
 					// Try to find in local stack
-					hash_t       variableName = read<hash_t>();
+					hash_t       variableName = operand<hash_t>();
 					const value* val          = get_var(variableName);
 
 #ifdef INK_ENABLE_STL
-					if (_debug_stream != nullptr) {
+					if constexpr (Traced) {
 						*_debug_stream << "variable_name ";
 						write_hash(*_debug_stream, variableName);
 						*_debug_stream << " val \"" << val << "\"";
@@ -1427,17 +1957,15 @@ void runner_impl::step()
 
 					inkAssert(val != nullptr, "Could not find variable!");
 					_eval.push(*val);
-					break;
+					INK_NEXT;
 				}
-				case Command::START_STR: {
-					read<uint32_t>();
+				INK_OPCODE(START_STR): {
 					inkAssert(_evaluation_mode, "Can not enter string mode while not in evaluation mode!");
 					_string_mode     = true;
 					_evaluation_mode = false;
 					_output << values::marker;
 				} break;
-				case Command::END_STR: {
-					read<uint32_t>();
+				INK_OPCODE(END_STR): {
 					// TODO: Assert we really had a marker on there?
 					inkAssert(! _evaluation_mode, "Must be in evaluation mode");
 					_string_mode     = false;
@@ -1451,25 +1979,23 @@ void runner_impl::step()
 				} break;
 
 				// == Tag commands
-				case Command::START_TAG: {
-					read<uint32_t>();
+				INK_OPCODE(START_TAG): {
 					_output << values::marker;
 				} break;
 
 
-				case Command::END_TAG: {
-					read<uint32_t>();
+				INK_OPCODE(END_TAG): {
 					auto tag = _output.get_alloc<true>(_globals->strings(), _globals->lists());
 					add_tag(tag, tags_level::UNKNOWN);
 				} break;
 
 				// == Choice commands
-				case Command::CHOICE: {
+				INK_OPCODE(CHOICE): {
 					// Read path
-					uint32_t path = read<uint32_t>();
+					uint32_t path = operand<uint32_t>();
 
 #ifdef INK_ENABLE_STL
-					if (_debug_stream != nullptr) {
+					if constexpr (Traced) {
 						*_debug_stream << "path " << path;
 					}
 #endif
@@ -1478,8 +2004,8 @@ void runner_impl::step()
 					//  been visited
 					if (flag & CommandFlag::CHOICE_IS_ONCE_ONLY) {
 						// Need to convert offset to container index
-						container_t destination = ~0U;
-						if (_story->find_container_id(path, destination)) {
+						container_t destination = operand_start_container();
+						if (destination != ~0U) {
 							// Ignore the choice if we've visited the destination before
 							if (_globals->visits(destination) > 0) {
 								break;
@@ -1538,9 +2064,9 @@ void runner_impl::step()
 					}
 					save();
 				} break;
-				case Command::START_CONTAINER_MARKER: {
+				INK_OPCODE(START_CONTAINER_MARKER): {
 					// Keep track of current container
-					auto index = read<uint32_t>();
+					auto index = operand<uint32_t>();
 					// offset points to command, command has size 6
 					_container.push(index);
 
@@ -1553,11 +2079,11 @@ void runner_impl::step()
 					if (flag & CommandFlag::CONTAINER_MARKER_IS_KNOT) {
 						_current_knot_id = index;
 						_entered_knot    = true;
+						break;
 					}
-
-				} break;
-				case Command::END_CONTAINER_MARKER: {
-					container_t index = read<container_t>();
+				} INK_NEXT;
+				INK_OPCODE(END_CONTAINER_MARKER): {
+					container_t index = operand<container_t>();
 					inkAssert(_container.top() == index, "Leaving container we are not in!");
 
 					// Move up out of the current container
@@ -1587,22 +2113,20 @@ void runner_impl::step()
 							                                  // != empty container stack)
 							on_done(true);
 						}
+						break;
 					}
-				} break;
-				case Command::VISIT: {
-					read<uint32_t>();
+				} INK_NEXT;
+				INK_OPCODE(VISIT): {
 					// Push the visit count for the current container to the top
 					//  is 0-indexed for some reason. idk why but this is what ink expects
 					_eval.push(value{}.set<value_type::int32>(
 					    static_cast<int32_t>(_globals->visits(_container.top()) - 1)
 					));
-				} break;
-				case Command::TURN: {
-					read<uint32_t>();
+				} INK_NEXT;
+				INK_OPCODE(TURN): {
 					_eval.push(value{}.set<value_type::int32>(static_cast<int32_t>(_globals->turns())));
-				} break;
-				case Command::SEQUENCE: {
-					read<uint32_t>();
+				} INK_NEXT;
+				INK_OPCODE(SEQUENCE): {
 					// TODO: The C# ink runtime does a bunch of fancy logic
 					//  to make sure each element is picked at least once in every
 					//  iteration loop. I don't feel like replicating that right now.
@@ -1614,42 +2138,117 @@ void runner_impl::step()
 
 					_eval.push(value{}.set<value_type::int32>(static_cast<int32_t>(_rng.rand(sequenceLength)))
 					);
-				} break;
-				case Command::SEED: {
-					read<uint32_t>();
+				} INK_NEXT;
+				INK_OPCODE(SEED): {
 					int32_t seed = _eval.pop().get<value_type::int32>();
 					_rng.srand(seed);
 
 #ifdef INK_ENABLE_STL
-					if (_debug_stream != nullptr) {
+					if constexpr (Traced) {
 						*_debug_stream << "seed " << seed;
 					}
 #endif
 
 					_eval.push(values::null);
-				} break;
+				} INK_NEXT;
 
-				case Command::READ_COUNT: {
+				INK_OPCODE(READ_COUNT): {
 					// Get container index
-					container_t container = read<container_t>();
+					container_t container = operand<container_t>();
 
 					// Push the read count for the requested container index
 					_eval.push(value{}.set<value_type::int32>(static_cast<int32_t>(_globals->visits(container)
 					)));
+				} INK_NEXT;
+				INK_OPCODE(TAG): {
+					add_tag(operand<const char*>(), tags_level::UNKNOWN);
+				} break;
+
+				// == Fused commands: execute the whole sequence, then skip the rest of it
+				INK_OPCODE(EVAL_STR): {
+					const char* str = fused_operand<const char*>(1);
+
+#ifdef INK_ENABLE_STL
+					if constexpr (Traced) {
+						*_debug_stream << "str \"" << str << "\"";
+					}
+#endif
+
+					_eval.push(value{}.set<value_type::string>(str, false));
+					_evaluation_mode = false;
+					_ptr += (fused_length(Command::EVAL_STR) - 1) * CommandSize<uint32_t>;
+				} INK_NEXT;
+				INK_OPCODE(EVAL_VARIABLE_OP_INT): {
+					hash_t       variableName = fused_operand<hash_t>(1);
+					int          operand      = fused_operand<int>(2);
+					Command      op           = fused_command(3);
+					const value* val          = get_var(variableName);
+
+#ifdef INK_ENABLE_STL
+					if constexpr (Traced) {
+						*_debug_stream << "variable_name ";
+						write_hash(*_debug_stream, variableName);
+						*_debug_stream << " int " << operand << " op " << op;
+					}
+#endif
+
+					inkAssert(val != nullptr, "Could not find variable!");
+					_eval.push(*val);
+					_eval.push(value{}.set<value_type::int32>(static_cast<int32_t>(operand)));
+					_operations(op, _eval);
+					_evaluation_mode = false;
+					_ptr += (fused_length(Command::EVAL_VARIABLE_OP_INT) - 1) * CommandSize<uint32_t>;
+				} INK_NEXT;
+				INK_OPCODE(TAG_STR): {
+					_output << values::marker;
+					if (_evaluation_mode) {
+						// the string would go to the evaluation stack, continue with the plain sequence
+						break;
+					}
+					_output << value{}.set<value_type::string>(fused_operand<const char*>(1), false);
+					add_tag(_output.get_alloc<true>(_globals->strings(), _globals->lists()), tags_level::UNKNOWN);
+					_ptr += (fused_length(Command::TAG_STR) - 1) * CommandSize<uint32_t>;
 				} break;
-				case Command::TAG: {
-					read<uint32_t>();
-					add_tag(read<const char*>(), tags_level::UNKNOWN);
+				INK_OPCODE(STR_NEWLINE): {
+					const char* str = operand<const char*>();
+
+#ifdef INK_ENABLE_STL
+					if constexpr (Traced) {
+						*_debug_stream << "str \"" << str << "\" newline";
+					}
+#endif
+
+					const CommandFlag newline_flag = fused_flag(1);
+					_ptr += (fused_length(Command::STR_NEWLINE) - 1) * CommandSize<uint32_t>;
+					if (_evaluation_mode) {
+						_eval.push(value{}.set<value_type::string>(str, false));
+						_eval.push(values::newline);
+						INK_NEXT;
+					} else {
+						_output << value{}.set<value_type::string>(str, false);
+						if (! _output.ends_with(value_type::newline)) {
+							_output << values::newline;
+							_ends_line = newline_flag & CommandFlag::NEWLINE_ENDS_LINE;
+						}
+					}
 				} break;
-				default: inkAssert(false, "Unrecognized command!"); break;
+
+				// == Operations (LIST_RANGE .. CHOICE_COUNT)
+				default:
+#ifdef INK_ENABLE_COMPUTED_GOTO
+				op_OPERATION:
+#endif
+				{
+					inkAssert(
+					    cmd >= Command::OP_BEGIN && cmd < Command::OP_END, "Unrecognized command!"
+					);
+					_operations(cmd, _eval);
+				} INK_NEXT;
 			}
+			break;
 		}
 
-#ifdef INK_ENABLE_STL
-		if (_debug_stream != nullptr) {
-			*_debug_stream << std::endl;
-		}
-#endif
+		trace_end<Traced>();
 	}
 #ifdef INK_ENABLE_EXCEPTIONS
 	catch (...) {
@@ -1659,6 +2258,13 @@ void runner_impl::step()
 	}
 #endif
 }
+#if defined(INK_ENABLE_COMPUTED_GOTO) && defined(__GNUC__)
+#	pragma GCC diagnostic pop
+#endif
+
+#undef INK_NEXT
+#undef INK_DISPATCH
+#undef INK_OPCODE
 
 void runner_impl::on_done(bool setDone)
 {
@@ -1710,6 +2316,9 @@ void runner_impl::reset()
 	_threads.clear();
 	_evaluation_mode = false;
 	_saved           = false;
+	_line_pending    = false;
+	_suspended       = false;
+	_resume_line     = false;
 	_choices.clear();
 	_ptr  = nullptr;
 	_done = nullptr;
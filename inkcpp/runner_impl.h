@@ -30,6 +30,7 @@
 namespace ink::runtime::internal
 {
 class story_impl;
+struct instruction;
 class globals_impl;
 class snapshot_impl;
 
@@ -55,11 +56,25 @@ public:
 	// used by the globals object to do garbage collection
 	void mark_used(string_table&, list_table&) const;
 
+	// used by the story runner pool: detach before the runner is kept, recycle when it is handed out
+	// again. recycle behaves like the constructor, but keeps all allocated memory
+	void detach();
+	void recycle(globals);
+
+	// used by the batch executor: runners stepped on different threads must not share globals
+	bool has_own_globals() const;
+
 	// enable debugging when steppnig through the execution
 #ifdef INK_ENABLE_STL
 	void set_debug_enabled(std::ostream* debug_stream) { _debug_stream = debug_stream; }
 #endif
 
+#ifdef INK_ENABLE_THREADED_DISPATCH
+	// step each instruction through the plain switch instead of executing runs of instructions,
+	// used to compare both dispatch engines in one build
+	void set_threaded_dispatch(bool enabled) { _threaded_dispatch = enabled; }
+#endif
+
 #pragma region runner Implementation
 
 	// sets seed for prng in runner
@@ -68,6 +83,13 @@ public:
 	// Checks that the runner can continue
 	virtual bool can_continue() const override;
 
+	// Waiting for an asynchronous external function
+	virtual bool is_suspended() const override { return _suspended; }
+
+	// Delivers the result of an asynchronous external function
+	virtual void resume_external(async_call token, ink::runtime::value result) override;
+	virtual void resume_external(async_call token) override;
+
 	// Begin iterating choices
 	virtual const choice* begin() const override { return _choices.begin(); }
 
@@ -120,6 +142,9 @@ public:
 	virtual hash_t get_current_knot() const override;
 
 	snapshot* create_snapshot() const override;
+	snapshot* create_delta_snapshot(const snapshot& base) const override;
+
+	runner clone() const override;
 
 	size_t               snap(unsigned char* data, snapper&) const;
 	const unsigned char* snap_load(const unsigned char* data, loader&);
@@ -128,6 +153,13 @@ public:
 	// c-style getline
 	virtual const char* getline_alloc() override;
 
+	// getline into a buffer
+	virtual size_t getline(char* buffer, size_t size) override;
+
+	// getline as spans
+	using runner_interface::stream_line;
+	virtual void stream_line(line_sink sink, void* context) override;
+
 	// move to path
 	virtual bool move_to(hash_t path) override;
 
@@ -146,6 +178,9 @@ public:
 	// Reads a line into a std::ostream
 	virtual void getline(std::ostream&) override;
 
+	// Reads a line into a std::string
+	virtual void getline(std::string&) override;
+
 	// get all into stream
 	virtual void getall(std::ostream&) override;
 #endif
@@ -156,8 +191,12 @@ protected:
 	virtual void internal_bind(hash_t name, internal::function_base* function) override;
 
 private:
-	// Advances the interpreter by a line. This fills the output buffer
-	void advance_line();
+	// Advances the interpreter by a line. This fills the output buffer. Returns false if an
+	// asynchronous external function suspended the runner before the line was complete
+	bool advance_line();
+
+	// Finishes a line after its output was read: falls through the fallback choice, if available
+	void end_line();
 
 	// Steps the interpreter a single instruction and returns
 	//  when it has hit a new line
@@ -166,9 +205,32 @@ private:
 	// Steps the interpreter a single instruction
 	void step();
 
+#ifdef INK_ENABLE_THREADED_DISPATCH
+	// Steps the interpreter over a run of instructions, which ends with the
+	//  first instruction that may change the state of the current line
+	void step_run();
+#endif
+
+	// Instruction dispatch loop behind step() and step_run(). Traced writes
+	//  each instruction to the debug stream, Run continues with the next
+	//  instruction until one may change the state of the current line
+	template<bool Traced, bool Run>
+	void execute();
+
+	// Loads the next instruction
+	template<bool Traced>
+	void fetch(Command& cmd, CommandFlag& flag);
+
+	// Ends the trace line of an instruction
+	template<bool Traced>
+	void trace_end();
+
 	// Resets the runtime
 	void reset();
 
+	// Registers with the globals, initializing them if necessary
+	void attach();
+
 	// == Save/Restore
 	void save();
 	void restore();
@@ -199,6 +261,22 @@ private:
 	template<typename T>
 	inline T read(optional<ip_t> pos = nullopt);
 
+	// Operand of the current instruction
+	template<typename T>
+	inline T operand() const;
+	// Jump target of the current instruction
+	inline ip_t operand_target() const;
+	// Innermost container of the jump target of the current instruction
+	inline container_t operand_target_container() const;
+	// Container starting at the operand offset of the current instruction, ~0 if none
+	inline container_t operand_start_container() const;
+	// Command, flag and operand of the n-th instruction after the current one, used by fused
+	// commands
+	inline Command     fused_command(int n) const;
+	inline CommandFlag fused_flag(int n) const;
+	template<typename T>
+	inline T fused_operand(int n) const;
+
 	choice& add_choice();
 	void    clear_choices();
 
@@ -216,7 +294,8 @@ private:
 	void fetch_tags(ip_t begin);
 
 	// Special code for jumping from the current IP to another
-	void     jump(ip_t, bool record_visits, bool track_knot_visit);
+	// the destination container is looked up, unless it is already known
+	void jump(ip_t, bool record_visits, bool track_knot_visit, container_t dest_hint = ~0U);
 	uint32_t _current_knot_id        = ~0U; // id to detect knot changes from the outside
 	uint32_t _current_knot_id_backup = ~0U;
 	uint32_t _entered_knot   = false; // if we are in the first action after a jump to an snitch/knot
@@ -224,7 +303,7 @@ private:
 
 	frame_type execute_return();
 	template<frame_type type>
-	void start_frame(uint32_t target);
+	void start_frame(ip_t target, container_t target_container = ~0U);
 
 	void on_done(bool setDone);
 	void set_done_ptr(ip_t ptr);
@@ -292,6 +371,13 @@ public:
 
 		const ip_t& operator[](size_t index) const { return get(index); }
 
+		// replaces the threads, their positions and the save point with the ones of other
+		void copy_from(const threads& other)
+		{
+			base::copy_from(other);
+			_threadDone.copy_from(other._threadDone);
+		}
+
 		// snapshot interface
 		size_t               snap(unsigned char* data, const snapper&) const override;
 		const unsigned char* snap_load(const unsigned char* data, const loader&) override;
@@ -321,6 +407,9 @@ private:
 	ip_t _backup = nullptr; // backup pointer
 	ip_t _done   = nullptr; // when we last hit a done
 
+	// Current instruction, if decoded (see config::predecodeInstructions)
+	const instruction* _inst = nullptr;
+
 	// Output stream
 	internal::stream < abs(config::limitOutputSize), config::limitOutputSize<0> _output;
 
@@ -358,8 +447,26 @@ private:
 
 	bool _saved = false;
 
+	// the last step wrote a newline which ends the line, see CommandFlag::NEWLINE_ENDS_LINE
+	bool _ends_line = false;
+
+	// waiting for the result of an asynchronous external function
+	bool _suspended = false;
+	// the next advance_line() continues a line interrupted by a suspension
+	bool _resume_line = false;
+	// token of the last asynchronous call
+	uint32_t _async_call = 0;
+
+	// the output holds a line which did not fit into the buffer of getline(char*, size_t)
+	bool _line_pending = false;
+
 	prng _rng;
 
+#ifdef INK_ENABLE_THREADED_DISPATCH
+	// execute runs of instructions with step_run(), see set_threaded_dispatch()
+	bool _threaded_dispatch = true;
+#endif
+
 #ifdef INK_ENABLE_STL
 	std::ostream* _debug_stream = nullptr;
 #endif
@@ -379,7 +486,16 @@ size_t runner_impl::threads<dynamic, N>::snap(unsigned char* data, const snapper
 {
 	unsigned char* ptr = data;
 	ptr += base::snap(data ? ptr : nullptr, snapper);
-	ptr += _threadDone.snap(data ? ptr : nullptr, snapper);
+	if (snapper.compact) {
+		// store positions relative to the instructions, shifted by one to keep nullptr distinct
+		ptr += _threadDone.snap(data ? ptr : nullptr, snapper, [&snapper](ip_t ip) {
+			return ip == nullptr
+			         ? ip
+			         : reinterpret_cast<ip_t>(static_cast<std::uintptr_t>(ip - snapper.instructions) + 1);
+		});
+	} else {
+		ptr += _threadDone.snap(data ? ptr : nullptr, snapper);
+	}
 	return static_cast<size_t>(ptr - data);
 }
 
@@ -389,6 +505,13 @@ const unsigned char*
 {
 	ptr = base::snap_load(ptr, loader);
 	ptr = _threadDone.snap_load(ptr, loader);
+	if (loader.compact) {
+		_threadDone.map_loaded([&loader](ip_t offset) {
+			return offset == nullptr
+			         ? offset
+			         : loader.instructions + (reinterpret_cast<std::uintptr_t>(offset) - 1);
+		});
+	}
 	return ptr;
 }
 
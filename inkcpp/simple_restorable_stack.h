@@ -51,6 +51,9 @@ public:
 	void restore();
 	void forget();
 
+	// replaces the content and the save point with the ones of other
+	void copy_from(const simple_restorable_stack& other);
+
 	virtual bool                 can_be_migrated() const;
 	virtual size_t               snap(unsigned char* data, const snapper&) const;
 	virtual const unsigned char* snap_load(const unsigned char* data, const loader&);
@@ -293,6 +296,28 @@ inline void simple_restorable_stack<T>::forget()
 	_save = _jump = InvalidIndex;
 }
 
+template<typename T>
+inline void simple_restorable_stack<T>::copy_from(const simple_restorable_stack& other)
+{
+	inkAssert(other._null == _null, "different null value compared to the copied stack!");
+	_pos       = other._pos;
+	_save      = other._save;
+	_jump      = other._jump;
+	size_t max = _pos;
+	if (_save != InvalidIndex && _save > max) {
+		max = _save;
+	}
+	if (_jump != InvalidIndex && _jump > max) {
+		max = _jump;
+	}
+	while (_size < max) {
+		overflow(_buffer, _size);
+	}
+	for (size_t i = 0; i < max; ++i) {
+		_buffer[i] = other._buffer[i];
+	}
+}
+
 template<typename T>
 bool simple_restorable_stack<T>::can_be_migrated() const
 {
@@ -300,14 +325,14 @@ bool simple_restorable_stack<T>::can_be_migrated() const
 }
 
 template<typename T>
-size_t simple_restorable_stack<T>::snap(unsigned char* data, const snapper&) const
+size_t simple_restorable_stack<T>::snap(unsigned char* data, const snapper& snapper) const
 {
 	unsigned char* ptr          = data;
 	bool           should_write = data != nullptr;
-	ptr                         = snap_write(ptr, _null, should_write);
-	ptr                         = snap_write(ptr, _pos, should_write);
-	ptr                         = snap_write(ptr, _save, should_write);
-	ptr                         = snap_write(ptr, _jump, should_write);
+	ptr                         = snap_write(ptr, _null, should_write, snapper);
+	ptr                         = snap_write(ptr, _pos, should_write, snapper);
+	ptr                         = snap_write(ptr, _save, should_write, snapper);
+	ptr                         = snap_write(ptr, _jump, should_write, snapper);
 	size_t max                  = _pos;
 	if (_save != InvalidIndex && _save > max) {
 		max = _save;
@@ -316,20 +341,21 @@ size_t simple_restorable_stack<T>::snap(unsigned char* data, const snapper&) con
 		max = _jump;
 	}
 	for (size_t i = 0; i < max; ++i) {
-		ptr = snap_write(ptr, _buffer[i], should_write);
+		ptr = snap_write(ptr, _buffer[i], should_write, snapper);
 	}
 	return static_cast<size_t>(ptr - data);
 }
 
 template<typename T>
-const unsigned char* simple_restorable_stack<T>::snap_load(const unsigned char* ptr, const loader&)
+const unsigned char*
+    simple_restorable_stack<T>::snap_load(const unsigned char* ptr, const loader& loader)
 {
 	T null;
-	ptr = snap_read(ptr, null);
+	ptr = snap_read(ptr, null, loader);
 	inkAssert(null == _null, "different null value compared to snapshot!");
-	ptr        = snap_read(ptr, _pos);
-	ptr        = snap_read(ptr, _save);
-	ptr        = snap_read(ptr, _jump);
+	ptr        = snap_read(ptr, _pos, loader);
+	ptr        = snap_read(ptr, _save, loader);
+	ptr        = snap_read(ptr, _jump, loader);
 	size_t max = _pos;
 	if (_save != InvalidIndex && _save > max) {
 		max = _save;
@@ -341,7 +367,7 @@ const unsigned char* simple_restorable_stack<T>::snap_load(const unsigned char*
 		overflow(_buffer, _size);
 	}
 	for (size_t i = 0; i < max; ++i) {
-		ptr = snap_read(ptr, _buffer[i]);
+		ptr = snap_read(ptr, _buffer[i], loader);
 	}
 	return ptr;
 }
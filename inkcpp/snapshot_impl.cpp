@@ -22,6 +22,14 @@ snapshot* snapshot::from_binary(const unsigned char* data, size_t length, bool f
 	return new internal::snapshot_impl(data, length, freeOnDestroy);
 }
 
+snapshot* snapshot::from_delta(const snapshot& base, const unsigned char* data, size_t length)
+{
+	const auto&    full_base   = reinterpret_cast<const internal::snapshot_impl&>(base);
+	size_t         full_length = 0;
+	unsigned char* full = internal::snapshot_impl::apply_delta(full_base, data, length, full_length);
+	return new internal::snapshot_impl(full, full_length, true);
+}
+
 #ifdef INK_ENABLE_STL
 snapshot* snapshot::from_file(const char* filename)
 {
@@ -64,14 +72,17 @@ bool snapshot_impl::can_be_migrated(const story& story) const
 	return can_be_migrated() || (story.hash() == _header.hash);
 }
 
-const unsigned char* snapshot_impl::get_data() const { return _file; }
+const unsigned char* snapshot_impl::get_data() const { return _delta ? _delta : _file; }
 
-size_t snapshot_impl::get_data_len() const { return _length; }
+size_t snapshot_impl::get_data_len() const { return _delta ? _delta_length : _length; }
 
-snapshot_impl::snapshot_impl(const globals_impl& globals)
+snapshot_impl::snapshot_impl(const globals_impl& globals, bool compact, bool async_state)
     : _managed{true}
 {
 	snapshot_interface::snapper snapper(globals.strings(), globals._owner->string(0));
+	snapper.instructions = globals._owner->instructions();
+	snapper.compact      = compact;
+	snapper.async_state  = async_state;
 	bool                        migratable = globals.can_be_migrated();
 	size_t                      runner_cnt = 0;
 
@@ -85,7 +96,14 @@ snapshot_impl::snapshot_impl(const globals_impl& globals)
 		_length += globals._owner->list_meta_size();
 	}
 
-	_length             = file_size(_length, runner_cnt, migratable);
+	_length = file_size(_length, runner_cnt, migratable);
+	// clear the padding too, so equal states give equal bytes for delta snapshots
+	memset(static_cast<void*>(&_header), 0, sizeof(_header));
+	if (async_state) {
+		_header.version = compact ? CompactVersion : PlainVersion;
+	} else {
+		_header.version = compact ? CompactVersionNoAsync : PlainVersionNoAsync;
+	}
 	_header.length      = _length;
 	_header.num_runners = runner_cnt;
 	_header.hash        = globals._owner->hash();
@@ -126,6 +144,183 @@ snapshot_impl::snapshot_impl(const globals_impl& globals)
 	}
 }
 
+namespace
+{
+	// A delta is a sequence of commands, each copies a literal run of bytes from the delta followed
+	// by a range of the base snapshot. The numbers are varints:
+	// literal_length, literal bytes, zigzag(base_offset - position), copy_length
+	struct delta_header {
+		static constexpr uint32_t Magic = ('I' << 24) | ('N' << 16) | ('K' << 8) | 'D';
+
+		uint32_t magic = Magic;
+		hash_t   base_hash;   // hash_data() of the full base snapshot
+		uint32_t base_length; // length of the full base snapshot
+		uint32_t length;      // length of the reconstructed snapshot
+	};
+
+	// Searching for copies works on blocks of this size
+	constexpr size_t delta_block = 8;
+
+	inline uint32_t block_key(const unsigned char* data)
+	{
+		uint64_t a;
+		memcpy(&a, data, sizeof(a));
+		return static_cast<uint32_t>((a * 0x9E3779B97F4A7C15ull) >> 32);
+	}
+
+	// varint which must end before end
+	inline const unsigned char*
+	    read_delta_varint(const unsigned char* ptr, const unsigned char* end, uint64_t& value)
+	{
+		const unsigned char* last = ptr;
+		while (last < end && (*last & 0x80)) {
+			++last;
+		}
+		inkAssert(last < end, "Corrupted delta snapshot");
+		return snapshot_interface::snap_read_varint(ptr, value);
+	}
+
+	// Finds the ranges of a snapshot which also appear in the base. The base is indexed at every
+	// block aligned offset, while the snapshot is searched at every offset, so content which moved
+	// because data in front of it changed is still found.
+	class delta_encoder
+	{
+	public:
+		delta_encoder(const unsigned char* base, size_t length)
+		    : _base{base}
+		    , _length{length}
+		{
+			size_t size = 1;
+			while (size < 2 * (length / delta_block) + 1) {
+				size *= 2;
+			}
+			_mask  = static_cast<uint32_t>(size - 1);
+			_table = new uint32_t[size]{};
+			for (size_t offset = 0; offset + delta_block <= length; offset += delta_block) {
+				uint32_t& slot = _table[block_key(base + offset) & _mask];
+				// keep the first occurrence
+				if (slot == 0) {
+					slot = static_cast<uint32_t>(offset + 1);
+				}
+			}
+		}
+
+		~delta_encoder() { delete[] _table; }
+
+		delta_encoder(const delta_encoder&)            = delete;
+		delta_encoder& operator=(const delta_encoder&) = delete;
+
+		// writes the commands to reconstruct data, if out is nullptr only the size is computed
+		size_t encode(const unsigned char* data, size_t length, unsigned char* out) const
+		{
+			using sn           = snapshot_interface;
+			unsigned char* ptr = out;
+			bool           write   = out != nullptr;
+			size_t         literal = 0;
+			size_t         i       = 0;
+			while (i + delta_block <= length) {
+				uint32_t slot = _table[block_key(data + i) & _mask];
+				if (slot == 0 || memcmp(_base + slot - 1, data + i, delta_block) != 0) {
+					++i;
+					continue;
+				}
+				size_t offset = slot - 1;
+				// grow the match in both directions
+				while (i > literal && offset > 0 && _base[offset - 1] == data[i - 1]) {
+					--i;
+					--offset;
+				}
+				size_t count = delta_block;
+				while (i + count < length && offset + count < _length
+				       && _base[offset + count] == data[i + count]) {
+					++count;
+				}
+				ptr = sn::snap_write_varint(ptr, i - literal, write);
+				ptr = sn::snap_write(ptr, data + literal, i - literal, write);
+				ptr = sn::snap_write_varint(
+				    ptr, sn::zigzag(static_cast<long long>(offset) - static_cast<long long>(i)), write
+				);
+				ptr = sn::snap_write_varint(ptr, count, write);
+				i += count;
+				literal = i;
+			}
+			// the rest is a literal without copy
+			ptr = sn::snap_write_varint(ptr, length - literal, write);
+			ptr = sn::snap_write(ptr, data + literal, length - literal, write);
+			ptr = sn::snap_write_varint(ptr, 0, write);
+			ptr = sn::snap_write_varint(ptr, 0, write);
+			return static_cast<size_t>(ptr - out);
+		}
+
+	private:
+		const unsigned char* _base;
+		size_t               _length;
+		uint32_t*            _table;
+		uint32_t             _mask;
+	};
+} // namespace
+
+snapshot_impl::snapshot_impl(const globals_impl& globals, const snapshot_impl& base)
+    : snapshot_impl(globals)
+{
+	delta_header header;
+	header.base_hash   = hash_data(base.full_data(), base.full_length());
+	header.base_length = static_cast<uint32_t>(base.full_length());
+	header.length      = static_cast<uint32_t>(_length);
+
+	delta_encoder encoder(base.full_data(), base.full_length());
+	_delta_length = sizeof(header) + encoder.encode(_file, _length, nullptr);
+	_delta        = new unsigned char[_delta_length];
+	memcpy(_delta, &header, sizeof(header));
+	encoder.encode(_file, _length, _delta + sizeof(header));
+}
+
+unsigned char* snapshot_impl::apply_delta(
+    const snapshot_impl& base, const unsigned char* data, size_t length, size_t& full_length
+)
+{
+	delta_header header;
+	inkAssert(length >= sizeof(header), "Delta snapshot is too short");
+	memcpy(&header, data, sizeof(header));
+	inkAssert(header.magic == delta_header::Magic, "Data is not a delta snapshot");
+	inkAssert(
+	    header.base_length == base.full_length()
+	        && header.base_hash == hash_data(base.full_data(), base.full_length()),
+	    "Delta snapshot was created against a different base snapshot"
+	);
+
+	unsigned char*       full = new unsigned char[header.length];
+	size_t               pos  = 0;
+	const unsigned char* ptr  = data + sizeof(header);
+	const unsigned char* end  = data + length;
+	while (ptr < end) {
+		uint64_t literal, distance, count;
+		ptr = read_delta_varint(ptr, end, literal);
+		inkAssert(
+		    static_cast<uint64_t>(end - ptr) >= literal && pos + literal <= header.length,
+		    "Corrupted delta snapshot"
+		);
+		ptr = snapshot_interface::snap_read(ptr, full + pos, static_cast<size_t>(literal));
+		pos += static_cast<size_t>(literal);
+		ptr              = read_delta_varint(ptr, end, distance);
+		ptr              = read_delta_varint(ptr, end, count);
+		if (count == 0) {
+			continue;
+		}
+		long long offset = static_cast<long long>(pos) + snapshot_interface::unzigzag(distance);
+		inkAssert(
+		    offset >= 0 && static_cast<uint64_t>(offset) + count <= base.full_length()
+		        && pos + count <= header.length,
+		    "Corrupted delta snapshot"
+		);
+		memcpy(full + pos, base.full_data() + offset, static_cast<size_t>(count));
+		pos += static_cast<size_t>(count);
+	}
+	inkAssert(pos == header.length, "Corrupted delta snapshot");
+	full_length = pos;
+	return full;
+}
+
 snapshot_impl::snapshot_impl(const unsigned char* data, size_t length, bool managed)
     : _file{data}
     , _length{length}
@@ -134,51 +329,55 @@ snapshot_impl::snapshot_impl(const unsigned char* data, size_t length, bool mana
 	const unsigned char* ptr = data;
 	memcpy(&_header, ptr, sizeof(_header));
 	inkAssert(_header.length == _length, "Corrupted file length");
-	inkAssert(_header.version == decltype(_header){}.version, "Snapshot version missmatch");
+	inkAssert(
+	    _header.version == PlainVersion || _header.version == CompactVersion
+	        || _header.version == PlainVersionNoAsync || _header.version == CompactVersionNoAsync,
+	    "Snapshot version missmatch"
+	);
 }
 
 size_t snap_choice::snap(unsigned char* data, const snapper& snapper) const
 {
 	unsigned char* ptr          = data;
 	bool           should_write = data != nullptr;
-	ptr                         = snap_write(ptr, _index, should_write);
-	ptr                         = snap_write(ptr, _path, should_write);
-	ptr                         = snap_write(ptr, _thread, should_write);
+	ptr                         = snap_write(ptr, _index, should_write, snapper);
+	ptr                         = snap_write(ptr, _path, should_write, snapper);
+	ptr                         = snap_write(ptr, _thread, should_write, snapper);
 	// handle difference between no tag and first tag
 	if (num_tags() == 0) {
 		ptr = snap_write(ptr, false, should_write);
 	} else {
 		ptr                         = snap_write(ptr, true, should_write);
 		std::uintptr_t offset_start = _tags_start - snapper.runner_tags;
-		ptr                         = snap_write(ptr, offset_start, should_write);
+		ptr                         = snap_write(ptr, offset_start, should_write, snapper);
 		std::uintptr_t offset_end   = _tags_end - snapper.runner_tags;
-		ptr                         = snap_write(ptr, offset_end, should_write);
+		ptr                         = snap_write(ptr, offset_end, should_write, snapper);
 	}
-	ptr = snap_write(ptr, snapper.strings.get_id(_text), should_write);
+	ptr = snap_write(ptr, snapper.strings.get_id(_text), should_write, snapper);
 	return static_cast<size_t>(ptr - data);
 }
 
 const unsigned char* snap_choice::snap_load(const unsigned char* data, const loader& loader)
 {
 	const unsigned char* ptr = data;
-	ptr                      = snap_read(ptr, _index);
-	ptr                      = snap_read(ptr, _path);
-	ptr                      = snap_read(ptr, _thread);
+	ptr                      = snap_read(ptr, _index, loader);
+	ptr                      = snap_read(ptr, _path, loader);
+	ptr                      = snap_read(ptr, _thread, loader);
 	bool has_tags;
 	ptr = snap_read(ptr, has_tags);
 	if (has_tags) {
 		std::uintptr_t offset_start = 0;
-		ptr                         = snap_read(ptr, offset_start);
+		ptr                         = snap_read(ptr, offset_start, loader);
 		_tags_start                 = loader.runner_tags + offset_start;
 		std::uintptr_t offset_end   = 0;
-		ptr                         = snap_read(ptr, offset_end);
+		ptr                         = snap_read(ptr, offset_end, loader);
 		_tags_end                   = loader.runner_tags + offset_end;
 	} else {
 		_tags_start = nullptr;
 		_tags_end   = nullptr;
 	}
 	size_t string_id;
-	ptr   = snap_read(ptr, string_id);
+	ptr   = snap_read(ptr, string_id, loader);
 	_text = loader.string_table[string_id];
 	return ptr;
 }
@@ -192,7 +391,7 @@ size_t snap_tag::snap(unsigned char* data, const snapper& snapper) const
 	} else {
 		size_t id = snapper.strings.get_id(_str);
 		ptr       = snap_write(ptr, true, should_write);
-		ptr       = snap_write(ptr, id, should_write);
+		ptr       = snap_write(ptr, id, should_write, snapper);
 	}
 	return static_cast<size_t>(ptr - data);
 }
@@ -206,7 +405,7 @@ const unsigned char* snap_tag::snap_load(const unsigned char* data, const loader
 		_str = nullptr;
 	} else {
 		size_t id;
-		ptr  = snap_read(ptr, id);
+		ptr  = snap_read(ptr, id, loader);
 		_str = loader.string_table[id];
 	}
 	return ptr;
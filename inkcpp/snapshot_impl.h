@@ -80,6 +80,7 @@ public:
 		if (_managed) {
 			delete[] _file;
 		}
+		delete[] _delta;
 	};
 
 	managed_array<const char*, true, 5>& strings() const { return string_table; }
@@ -87,13 +88,22 @@ public:
 	const unsigned char* get_data() const override;
 	size_t               get_data_len() const override;
 
-	snapshot_impl(const globals_impl&);
+	// compact selects the encoding, the plain format is still written for comparisons. Without
+	// async_state the formats of version 1 and 2 are written, to test loading older snapshots.
+	snapshot_impl(const globals_impl&, bool compact = true, bool async_state = true);
+	// full snapshot, whose blob is the delta to base
+	snapshot_impl(const globals_impl&, const snapshot_impl& base);
 	// write down all allocated strings
 	// replace pointer with idx
 	// reconsrtuct static strings index
 	// list_table _data & _entry_state
 	snapshot_impl(const unsigned char* data, size_t length, bool managed);
 
+	// reconstructs the full blob of a delta snapshot, the result is allocated with new[]
+	static unsigned char* apply_delta(
+	    const snapshot_impl& base, const unsigned char* data, size_t length, size_t& full_length
+	);
+
 	const unsigned char* get_globals_snap() const { return _file + get_offset(0); }
 
 	const unsigned char* get_runner_snap(size_t idx) const { return _file + get_offset(idx + 1); }
@@ -104,8 +114,27 @@ public:
 
 	bool can_be_migrated() const override { return _header.migratable; }
 
+	bool is_delta() const override { return _delta != nullptr; }
+
+	// blob of the full snapshot, get_data() of a delta snapshot only contains the changes
+	const unsigned char* full_data() const { return _file; }
+
+	size_t full_length() const { return _length; }
+
 	bool can_be_migrated(const story&) const;
 
+	// snapshot uses the compact encoding, see snapshot_interface::snapper::compact
+	bool compact() const
+	{
+		return _header.version == CompactVersion || _header.version == CompactVersionNoAsync;
+	}
+	// runners store the state of asynchronous external function calls and pending lines
+	// runners store the state of asynchronous external function calls
+	bool async_state() const
+	{
+		return _header.version == PlainVersion || _header.version == CompactVersion;
+	}
+
 	hash_t hash() const { return _header.hash; }
 
 
@@ -118,14 +147,25 @@ private:
 	bool                                        _managed;
 	static size_t                               file_size(size_t, size_t, bool);
 
+	// changes to the base snapshot, only set for delta snapshots
+	unsigned char* _delta        = nullptr;
+	size_t         _delta_length = 0;
+
 	struct header {
 		size_t num_runners;
 		size_t length;
 		hash_t hash;
 		bool   migratable;
-		size_t version = 1;
+		size_t version = CompactVersion;
 	} _header;
 
+	// version 3 and 4 store the state of asynchronous external function calls, older versions
+	// are still loaded as runners without a pending call
+	static constexpr size_t PlainVersionNoAsync   = 1;
+	static constexpr size_t CompactVersionNoAsync = 2;
+	static constexpr size_t PlainVersion          = 3;
+	static constexpr size_t CompactVersion        = 4;
+
 	size_t get_offset(size_t idx) const
 	{
 		inkAssert(
@@ -7,7 +7,9 @@
 #pragma once
 
 #include "system.h"
+#include "traits.h"
 
+#include <cstdint>
 #include <cstring>
 
 namespace ink::runtime::internal
@@ -50,10 +52,73 @@ public:
 		return snap_read(ptr, &data, sizeof(data));
 	}
 
+	/// LEB128 encoded unsigned integer, used by the compact format
+	static unsigned char* snap_write_varint(unsigned char* ptr, uint64_t value, bool write)
+	{
+		do {
+			unsigned char byte = static_cast<unsigned char>(value & 0x7F);
+			value >>= 7;
+			if (value) {
+				byte |= 0x80;
+			}
+			if (write) {
+				*ptr = byte;
+			}
+			++ptr;
+		} while (value);
+		return ptr;
+	}
+
+	static const unsigned char* snap_read_varint(const unsigned char* ptr, uint64_t& value)
+	{
+		value = 0;
+		for (unsigned shift = 0;; shift += 7) {
+			inkAssert(shift < 64, "Corrupted varint in snapshot.");
+			unsigned char byte = *ptr++;
+			value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if (! (byte & 0x80)) {
+				return ptr;
+			}
+		}
+	}
+
+	/// maps signed integers to unsigned, so small negative values also give short varints
+	static uint64_t zigzag(long long value)
+	{
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value < 0 ? -1 : 0);
+	}
+
+	static long long unzigzag(uint64_t value)
+	{
+		return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+	}
+
+	struct snapper;
+	struct loader;
+
+	/** Writes a value in the format selected by the snapper.
+	 * The compact format stores pointer sized integers and pointers as one zigzag varint and splits
+	 * other types with a size multiple of 4 bytes into 32bit words, each stored as zigzag varint.
+	 * Small values and the common ~0 sentinels take one byte, and the result does not depend on
+	 * the pointer size. Everything else is copied like in the plain format.
+	 */
+	template<typename T>
+	static unsigned char*
+	    snap_write(unsigned char* ptr, const T& data, bool write, const snapper& snapper);
+
+	/// Reads a value written by snap_write() in the format selected by the loader
+	template<typename T>
+	static const unsigned char* snap_read(const unsigned char* ptr, T& data, const loader& loader);
+
 	struct snapper {
 		const string_table& strings;
 		const char*         story_string_table;
-		const snap_tag*     runner_tags = nullptr;
+		const snap_tag*     runner_tags  = nullptr;
+		ip_t                instructions = nullptr;
+		/// use the compact encoding (snapshot format version 2 and 4)
+		bool                compact      = false;
+		/// store the state of asynchronous calls and pending lines (snapshot format version 3 and 4)
+		bool                async_state  = true;
 
 		snapper(const string_table& strings, const char* story_string_table)
 		    : strings{strings}
@@ -68,16 +133,23 @@ public:
 	struct loader {
 		managed_array<const char*, true, 5>& string_table; /// FIXME: make configurable
 		const char*                          story_string_table;
-		const bool                           migratable  = false;
-		const snap_tag*                      runner_tags = nullptr;
+		const bool                           migratable   = false;
+		const snap_tag*                      runner_tags  = nullptr;
+		ip_t                                 instructions = nullptr;
+		/// data is in the compact encoding (snapshot format version 2 and 4)
+		const bool                           compact      = false;
+		/// runners store the state of asynchronous calls and pending lines (format version 3 and 4)
+		const bool                           async_state  = true;
 
 		loader(
 		    managed_array<const char*, true, 5>& string_table, const char* story_string_table,
-		    bool migratable
+		    bool migratable, bool compact = false, bool async_state = true
 		)
 		    : string_table{string_table}
 		    , story_string_table{story_string_table}
 		    , migratable(migratable)
+		    , compact(compact)
+		    , async_state(async_state)
 		{
 		}
 
@@ -122,5 +194,65 @@ public:
 #else
 #	pragma warning(pop)
 #endif
+
+private:
+	template<typename T>
+	static constexpr bool is_pointer_sized()
+	{
+		return is_pointer<T>::value || is_same<T, std::uintptr_t>::value;
+	}
+
 };
+
+template<typename T>
+inline unsigned char* snapshot_interface::snap_write(
+    unsigned char* ptr, const T& data, bool write, const snapper& snapper
+)
+{
+	if (! snapper.compact) {
+		return snap_write(ptr, data, write);
+	}
+	if constexpr (is_pointer_sized<T>()) {
+		// sign extend, so ~0 looks the same on 32 and 64 bit
+		return snap_write_varint(
+		    ptr, zigzag(static_cast<ptrdiff_t>(reinterpret_cast<std::uintptr_t>(data))), write
+		);
+	} else if constexpr (sizeof(T) % sizeof(int32_t) == 0) {
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&data);
+		for (size_t i = 0; i < sizeof(T); i += sizeof(int32_t)) {
+			int32_t word;
+			memcpy(&word, bytes + i, sizeof(word));
+			ptr = snap_write_varint(ptr, zigzag(word), write);
+		}
+		return ptr;
+	} else {
+		return snap_write(ptr, data, write);
+	}
+}
+
+template<typename T>
+inline const unsigned char*
+    snapshot_interface::snap_read(const unsigned char* ptr, T& data, const loader& loader)
+{
+	if (! loader.compact) {
+		return snap_read(ptr, data);
+	}
+	if constexpr (is_pointer_sized<T>()) {
+		uint64_t value;
+		ptr  = snap_read_varint(ptr, value);
+		data = reinterpret_cast<T>(static_cast<std::uintptr_t>(unzigzag(value)));
+		return ptr;
+	} else if constexpr (sizeof(T) % sizeof(int32_t) == 0) {
+		unsigned char* bytes = reinterpret_cast<unsigned char*>(&data);
+		for (size_t i = 0; i < sizeof(T); i += sizeof(int32_t)) {
+			uint64_t value;
+			ptr          = snap_read_varint(ptr, value);
+			int32_t word = static_cast<int32_t>(unzigzag(value));
+			memcpy(bytes + i, &word, sizeof(word));
+		}
+		return ptr;
+	} else {
+		return snap_read(ptr, data);
+	}
+}
 } // namespace ink::runtime::internal
@@ -118,36 +118,77 @@ private:
 
 const value* basic_stack::get(hash_t name) const
 {
+	return const_cast<basic_stack*>(this)->get(name);
+}
+
+value* basic_stack::get(hash_t name)
+{
+	// Position is still known from the last search
+	slot& cached = _slots[name % SlotCacheSize];
+	if (cached.name == name && cached.epoch == _epoch) {
+		return &base::at(cached.position).data;
+	}
+
 	// Find whatever comes first: a matching entry or a stack frame entry
-	const entry* found = base::reverse_find(reverse_find_predicat_operator(name));
+	entry* found = base::reverse_find(reverse_find_predicat_operator(name));
 
 	// If nothing found, no value
 	if (found == nullptr)
 		return nullptr;
 
 	// If we found something of that name, return the value
-	if (found->name == name)
+	if (found->name == name) {
+		cached = {name, _epoch, static_cast<uint32_t>(found - &base::at(0))};
 		return &found->data;
+	}
 
 	// Otherwise, nothing in this stack frame
 	return nullptr;
 }
 
-value* basic_stack::get(hash_t name)
+void basic_stack::invalidate_slots()
 {
-	// Find whatever comes first: a matching entry or a stack frame entry
-	entry* found = base::reverse_find(reverse_find_predicat_operator(name));
+	_epoch = _next_epoch++;
 
-	// If nothing found, no value
-	if (found == nullptr)
-		return nullptr;
+	// On overflow old epochs could become valid again
+	if (_next_epoch == 0) {
+		for (slot& s : _slots) {
+			s = slot{};
+		}
+		for (uint32_t& e : _frame_epochs) {
+			e = 0;
+		}
+		_epoch      = 1;
+		_next_epoch = 2;
+	}
+}
 
-	// If we found something of that name, return the value
-	if (found->name == name)
-		return &found->data;
+void basic_stack::reset_slots()
+{
+	for (uint32_t& e : _frame_epochs) {
+		e = 0;
+	}
+	invalidate_slots();
+}
 
-	// Otherwise, nothing in this stack frame
-	return nullptr;
+void basic_stack::enter_frame_slots()
+{
+	if (_frame_depth < SlotFrameDepth) {
+		_frame_epochs[_frame_depth] = _epoch;
+	}
+	++_frame_depth;
+	invalidate_slots();
+}
+
+void basic_stack::leave_frame_slots()
+{
+	// The layout of the calling frame is unchanged, unless it got reset in between
+	if (_frame_depth > 0 && --_frame_depth < SlotFrameDepth && _frame_epochs[_frame_depth] != 0) {
+		_epoch                      = _frame_epochs[_frame_depth];
+		_frame_epochs[_frame_depth] = 0;
+	} else {
+		invalidate_slots();
+	}
 }
 
 value* basic_stack::get_from_frame(int ci, hash_t name)
@@ -169,18 +210,21 @@ template<>
 void basic_stack::push_frame<frame_type::function>(offset_t return_to, bool eval)
 {
 	add(InvalidHash, value{}.set<value_type::function_frame>(return_to, eval));
+	enter_frame_slots();
 }
 
 template<>
 void basic_stack::push_frame<frame_type::tunnel>(offset_t return_to, bool eval)
 {
 	add(InvalidHash, value{}.set<value_type::tunnel_frame>(return_to, eval));
+	enter_frame_slots();
 }
 
 template<>
 void basic_stack::push_frame<frame_type::thread>(offset_t return_to, bool eval)
 {
 	add(InvalidHash, value{}.set<value_type::thread_frame>(return_to, eval));
+	enter_frame_slots();
 }
 
 const entry* basic_stack::pop()
@@ -294,6 +338,7 @@ offset_t basic_stack::pop_frame(frame_type* type, bool& eval)
 
 				// Do a pop back
 				returnedFrame = do_thread_jump_pop(base::begin());
+				reset_slots();
 				break;
 			}
 
@@ -301,18 +346,21 @@ offset_t basic_stack::pop_frame(frame_type* type, bool& eval)
 			if (frame->data.type() == value_type::jump_marker) {
 				// Use the thread jump pop method using this jump marker
 				returnedFrame = do_thread_jump_pop(iter);
+				reset_slots();
 				break;
 			}
 
 			// Popping past thread start
 			if (frame->data.type() == value_type::thread_start) {
 				returnedFrame = do_thread_jump_pop(iter);
+				reset_slots();
 				break;
 			}
 		}
 
 		// Otherwise, pop the frame marker off and return it
 		returnedFrame = pop();
+		leave_frame_slots();
 		break;
 	}
 
@@ -390,7 +438,12 @@ bool basic_stack::has_frame(frame_type* returnType) const
 	return frame != nullptr;
 }
 
-void basic_stack::clear() { base::clear(); }
+void basic_stack::clear()
+{
+	base::clear();
+	reset_slots();
+	_frame_depth = 0;
+}
 
 void basic_stack::mark_used(string_table& strings, list_table& lists) const
 {
@@ -411,6 +464,7 @@ thread_t basic_stack::fork_thread()
 
 	// Push a thread start marker here
 	add(InvalidHash, value{}.set<value_type::thread_start>(new_thread, 0u));
+	reset_slots();
 
 	// Set stack jump counter for thread to 0. This number is used if the thread ever
 	//  tries to pop past its origin. It keeps track of how much of the preceeding stack it's popped
@@ -423,10 +477,13 @@ void basic_stack::complete_thread(thread_t thread)
 {
 	// Add a thread complete marker
 	add(InvalidHash, value{}.set<value_type::thread_end>(thread));
+	reset_slots();
 }
 
 void basic_stack::collapse_to_thread(thread_t thread)
 {
+	reset_slots();
+
 	// Reset thread counter
 	_next_thread = 0;
 
@@ -512,6 +569,7 @@ void basic_stack::save()
 void basic_stack::restore()
 {
 	base::restore();
+	reset_slots();
 
 	// Restore thread counter
 	_next_thread = _backup_next_thread;
@@ -520,9 +578,156 @@ void basic_stack::restore()
 void basic_stack::forget()
 {
 	base::forget([](entry& elem) { elem.name = ~0U; });
+	reset_slots();
 }
 
-entry& basic_stack::add(hash_t name, const value& val) { return base::push({name, val}); }
+entry& basic_stack::add(hash_t name, const value& val)
+{
+	entry& added = base::push({name, val});
+
+	// The new entry is the first one a search would find
+	if (name != InvalidHash) {
+		_slots[name % SlotCacheSize]
+		    = {name, _epoch, static_cast<uint32_t>(&added - &base::at(0))};
+	}
+	return added;
+}
+
+basic_variable_stack::basic_variable_stack()
+    : basic_stack(nullptr, 0)
+{
+}
+
+void basic_variable_stack::overflow_index(index_slot*&, size_t&)
+{
+	inkFail("Variable index run out of memory!");
+}
+
+void basic_variable_stack::set(hash_t name, const value& val)
+{
+	// During a lookahead only values behind the save point may be changed
+	size_t position = base::is_saved() ? find_lookahead(name) : find(name);
+	if (position != ~0U) {
+		base::at(position).data = val;
+		return;
+	}
+
+	add(name, val);
+	if (! base::is_saved()) {
+		index(name, base::top_index() - 1);
+	}
+}
+
+const value* basic_variable_stack::get(hash_t name) const
+{
+	size_t position = base::is_saved() ? find_lookahead(name) : ~0U;
+	if (position == ~0U) {
+		position = find(name);
+	}
+	return position == ~0U ? nullptr : &base::at(position).data;
+}
+
+value* basic_variable_stack::get(hash_t name)
+{
+	return const_cast<value*>(static_cast<const basic_variable_stack*>(this)->get(name));
+}
+
+void basic_variable_stack::clear()
+{
+	basic_stack::clear();
+	rebuild_index();
+}
+
+void basic_variable_stack::forget()
+{
+	// Keep the values set during the lookahead, restore has nothing to do since they were never
+	// indexed
+	const size_t save = base::save_index();
+	basic_stack::forget();
+	for (size_t i = save; i < base::top_index(); ++i) {
+		index(base::at(i).name, i);
+	}
+}
+
+bool basic_variable_stack::migrate(basic_variable_stack& new_stack)
+{
+	bool result = basic_stack::migrate(new_stack);
+	new_stack.rebuild_index();
+	rebuild_index();
+	return result;
+}
+
+const unsigned char* basic_variable_stack::snap_load(const unsigned char* ptr, const loader& loader)
+{
+	ptr = basic_stack::snap_load(ptr, loader);
+	rebuild_index();
+	return ptr;
+}
+
+size_t basic_variable_stack::find(hash_t name) const
+{
+	if (_indexed == 0) {
+		return ~0U;
+	}
+	const size_t mask = _index_size - 1;
+	for (size_t i = name & mask;; i = (i + 1) & mask) {
+		if (_index[i].name == name) {
+			return _index[i].position;
+		}
+		if (_index[i].name == InvalidHash) {
+			return ~0U;
+		}
+	}
+}
+
+size_t basic_variable_stack::find_lookahead(hash_t name) const
+{
+	for (size_t i = base::top_index(); i > base::save_index(); --i) {
+		if (base::at(i - 1).name == name) {
+			return i - 1;
+		}
+	}
+	return ~0U;
+}
+
+void basic_variable_stack::index(hash_t name, size_t position)
+{
+	if (name == InvalidHash) {
+		return;
+	}
+
+	// Keep the index at most half full
+	if ((_indexed + 1) * 2 > _index_size) {
+		overflow_index(_index, _index_size);
+		inkAssert(
+		    (_index_size & (_index_size - 1)) == 0, "Variable index size must be a power of two!"
+		);
+		rebuild_index();
+	}
+
+	const size_t mask = _index_size - 1;
+	size_t       i    = name & mask;
+	while (_index[i].name != name && _index[i].name != InvalidHash) {
+		i = (i + 1) & mask;
+	}
+	if (_index[i].name == InvalidHash) {
+		++_indexed;
+	}
+	_index[i] = {name, static_cast<uint32_t>(position)};
+}
+
+void basic_variable_stack::rebuild_index()
+{
+	for (size_t i = 0; i < _index_size; ++i) {
+		_index[i].name = InvalidHash;
+	}
+	_indexed = 0;
+
+	const size_t end = base::is_saved() ? base::save_index() : base::top_index();
+	for (size_t i = 0; i < end; ++i) {
+		index(base::at(i).name, i);
+	}
+}
 
 basic_eval_stack::basic_eval_stack(value* data, size_t size)
     : base(data, size)
@@ -634,21 +839,40 @@ void basic_stack::push_values(basic_stack& stack)
 	}
 }
 
+void basic_stack::copy_from(const basic_stack& other)
+{
+	base::copy_from(other);
+	_next_thread        = other._next_thread;
+	_backup_next_thread = other._backup_next_thread;
+	// the cached positions stay valid, the entries are at the same positions
+	for (size_t i = 0; i < SlotCacheSize; ++i) {
+		_slots[i] = other._slots[i];
+	}
+	for (size_t i = 0; i < SlotFrameDepth; ++i) {
+		_frame_epochs[i] = other._frame_epochs[i];
+	}
+	_epoch       = other._epoch;
+	_next_epoch  = other._next_epoch;
+	_frame_depth = other._frame_depth;
+}
+
 size_t basic_stack::snap(unsigned char* data, const snapper& snapper) const
 {
 	unsigned char* ptr          = data;
 	bool           should_write = data != nullptr;
-	ptr                         = snap_write(ptr, _next_thread, should_write);
-	ptr                         = snap_write(ptr, _backup_next_thread, should_write);
+	ptr                         = snap_write(ptr, _next_thread, should_write, snapper);
+	ptr                         = snap_write(ptr, _backup_next_thread, should_write, snapper);
 	ptr += base::snap(data ? ptr : nullptr, snapper);
 	return static_cast<size_t>(ptr - data);
 }
 
 const unsigned char* basic_stack::snap_load(const unsigned char* ptr, const loader& loader)
 {
-	ptr = snap_read(ptr, _next_thread);
-	ptr = snap_read(ptr, _backup_next_thread);
+	ptr = snap_read(ptr, _next_thread, loader);
+	ptr = snap_read(ptr, _backup_next_thread, loader);
 	ptr = base::snap_load(ptr, loader);
+	reset_slots();
+	_frame_depth = 0;
 	return ptr;
 }
 } // namespace ink::runtime::internal
@@ -94,22 +94,54 @@ namespace runtime
 			// push all values to other _stack
 			void push_values(basic_stack& _stack);
 
+			// replaces the content, the save point and the thread ids with the ones of other
+			void copy_from(const basic_stack& other);
+
 			// snapshot interface
 			size_t               snap(unsigned char* data, const snapper&) const;
 			const unsigned char* snap_load(const unsigned char* data, const loader&);
 			bool                 can_be_migrated() const;
 
+		protected:
+			entry& add(hash_t name, const value& val);
+
 		private:
-			entry&       add(hash_t name, const value& val);
 			const entry* pop();
 
 			entry* do_thread_jump_pop(const iterator& jump);
 
+			// Starts a new epoch for the current frame
+			void invalidate_slots();
+			// Drops the cached positions of all frames
+			void reset_slots();
+			// New frames start without cached positions, the caller gets its own back on return
+			void enter_frame_slots();
+			void leave_frame_slots();
+
 			// thread ids
 			thread_t _next_thread        = 0;
 			thread_t _backup_next_thread = 0;
 
 			static const hash_t NulledHashId = ~0U;
+
+			// Stack positions of recently accessed variables, only valid within the epoch they were
+			// found in. Each frame gets a new epoch, which changes again on anything that could alter
+			// the result of a search through the frame (shadowing, threads, restore, ...).
+			struct slot {
+				hash_t   name     = InvalidHash;
+				uint32_t epoch    = 0;
+				uint32_t position = 0;
+			};
+
+			static constexpr size_t SlotCacheSize  = 16;
+			static constexpr size_t SlotFrameDepth = 16;
+
+			mutable slot _slots[SlotCacheSize];
+			uint32_t     _epoch      = 1;
+			uint32_t     _next_epoch = 2;
+			// epochs of the calling frames, 0 if they can not be reused
+			uint32_t     _frame_epochs[SlotFrameDepth] = {};
+			uint32_t     _frame_depth                  = 0;
 		};
 
 		template<>
@@ -164,6 +196,113 @@ namespace runtime
 			managed_array<entry, true, N> _stack;
 		};
 
+		/**
+		 * @brief stack without frames for the global variables
+		 * Variables are found through an open addressing hash index from name to stack position
+		 * instead of a reverse search. Only entries before the save point are indexed, values set
+		 * during a lookahead are stored behind it and searched linearly until they are forgotten.
+		 */
+		class basic_variable_stack : public basic_stack
+		{
+		protected:
+			struct index_slot {
+				hash_t   name;
+				uint32_t position;
+			};
+
+			basic_variable_stack();
+
+			// Called when the index is full, the new size must be a power of two
+			virtual void overflow_index(index_slot*& buffer, size_t& size);
+
+		public:
+			// Sets existing value, or creates a new one
+			void set(hash_t name, const value& val);
+
+			// Gets an existing value, or nullptr
+			const value* get(hash_t name) const;
+			value*       get(hash_t name);
+
+			// Clears the entire stack
+			void clear();
+
+			// == Save/Restore ==
+			void forget();
+
+			// copy new elements from _new, and delete elements now longer existing
+			bool migrate(basic_variable_stack& _new);
+
+			// snapshot interface
+			const unsigned char* snap_load(const unsigned char* data, const loader&);
+
+		private:
+			// position of the variable in the stack or ~0
+			size_t find(hash_t name) const;
+
+			// searches the values set since the save point
+			size_t find_lookahead(hash_t name) const;
+
+			// points the index for name to position
+			void index(hash_t name, size_t position);
+
+			// reindex all entries before the save point
+			void rebuild_index();
+
+			index_slot* _index      = nullptr;
+			size_t      _index_size = 0;
+			size_t      _indexed    = 0;
+		};
+
+		/**
+		 * @brief stack with hash index for global variables
+		 * @tparam N initial capacity of stack
+		 * @tparam Dynamic weather or not expand if stack is full
+		 */
+		template<size_t N, bool Dynamic = false>
+		class variable_stack : public basic_variable_stack
+		{
+			// index is kept at most half full
+			static constexpr size_t index_capacity()
+			{
+				size_t capacity = 1;
+				while (capacity < 2 * N) {
+					capacity *= 2;
+				}
+				return capacity;
+			}
+
+		protected:
+			virtual void overflow(entry*& buffer, size_t& size) override
+			{
+				if (buffer) {
+					if constexpr (Dynamic) {
+						_stack.extend();
+					} else {
+						basic_variable_stack::overflow(buffer, size);
+					}
+				}
+				buffer = _stack.data();
+				size   = _stack.capacity();
+			}
+
+			virtual void overflow_index(index_slot*& buffer, size_t& size) override
+			{
+				if (buffer) {
+					if constexpr (Dynamic) {
+						_index.extend(_index.capacity() * 2);
+					} else {
+						basic_variable_stack::overflow_index(buffer, size);
+					}
+				}
+				buffer = _index.data();
+				size   = _index.capacity();
+			}
+
+		private:
+			managed_array<entry, Dynamic, N>                    _stack;
+			managed_array<index_slot, Dynamic, index_capacity()> _index;
+		};
+
 		class basic_eval_stack : protected restorable<value>
 		{
 		protected:
@@ -202,6 +341,9 @@ namespace runtime
 			void restore();
 			void forget();
 
+			// replaces the content and the save point with the ones of other
+			void copy_from(const basic_eval_stack& other) { base::copy_from(other); }
+
 			// snapshot interface
 			size_t snap(unsigned char* data, const snapper& snapper) const
 			{
@@ -13,12 +13,32 @@
 #include "snapshot_interface.h"
 #include "version.h"
 
+#ifdef INK_ENABLE_MMAP
+#	ifdef _WIN32
+#		define WIN32_LEAN_AND_MEAN
+#		define NOMINMAX
+#		include <windows.h>
+#	else
+#		include <fcntl.h>
+#		include <sys/mman.h>
+#		include <sys/stat.h>
+#		include <unistd.h>
+#	endif
+#endif
+
 namespace ink::runtime
 {
 #ifdef INK_ENABLE_STL
 story* story::from_file(const char* filename) { return new internal::story_impl(filename); }
 #endif
 
+#ifdef INK_ENABLE_MMAP
+story* story::from_mmap(const char* filename)
+{
+	return new internal::story_impl(filename, internal::story_impl::map_file_t{});
+}
+#endif
+
 story* story::from_binary(const unsigned char* data, size_t length, bool freeOnDestroy)
 {
 	return new internal::story_impl(data, length, freeOnDestroy);
@@ -67,6 +87,68 @@ story_impl::story_impl(const char* filename)
 }
 #endif
 
+#ifdef INK_ENABLE_MMAP
+const unsigned char* map_file_into_memory(const char* filename, size_t* length)
+{
+#	ifdef _WIN32
+	HANDLE file = CreateFileA(
+	    filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr
+	);
+	inkAssert(file != INVALID_HANDLE_VALUE, "Failed to open file: " FORMAT_STRING_STR, filename);
+	LARGE_INTEGER size;
+	GetFileSizeEx(file, &size);
+	HANDLE mapping = size.QuadPart > 0
+	                     ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr)
+	                     : nullptr;
+	CloseHandle(file);
+	inkAssert(mapping != nullptr, "Failed to map file: " FORMAT_STRING_STR, filename);
+	void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	// the view keeps the mapping alive
+	CloseHandle(mapping);
+	inkAssert(data != nullptr, "Failed to map file: " FORMAT_STRING_STR, filename);
+	*length = static_cast<size_t>(size.QuadPart);
+#	else
+	int fd = open(filename, O_RDONLY);
+	inkAssert(fd >= 0, "Failed to open file: " FORMAT_STRING_STR, filename);
+	struct stat info;
+	void*       data = MAP_FAILED;
+	if (fstat(fd, &info) == 0 && info.st_size > 0) {
+		data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+	}
+	// the mapping stays valid after the file is closed
+	close(fd);
+	inkAssert(data != MAP_FAILED, "Failed to map file: " FORMAT_STRING_STR, filename);
+	*length = static_cast<size_t>(info.st_size);
+#	endif
+	return static_cast<const unsigned char*>(data);
+}
+
+void unmap_file(const unsigned char* data, [[maybe_unused]] size_t length)
+{
+#	ifdef _WIN32
+	UnmapViewOfFile(data);
+#	else
+	munmap(const_cast<unsigned char*>(data), length);
+#	endif
+}
+
+story_impl::story_impl(const char* filename, map_file_t)
+    : _file(nullptr)
+    , _length(0)
+    , _managed(false)
+{
+	_file          = map_file_into_memory(filename, &_length);
+	_mapped_length = _length;
+
+	// Find all the right data sections, the sections are used in place
+	setup_pointers();
+
+	// create story block
+	_block             = new internal::ref_block();
+	_block->references = 1;
+}
+#endif
+
 story_impl::story_impl(const unsigned char* binary, size_t len, bool manage /*= true*/)
     : _file(binary)
     , _length(len)
@@ -82,13 +164,24 @@ story_impl::story_impl(const unsigned char* binary, size_t len, bool manage /*=
 
 story_impl::~story_impl()
 {
+	for (runner_impl* thread : _runner_pool) {
+		delete thread;
+	}
+	_runner_pool.clear();
+
 	// delete file memory if we're responsible for it
+#ifdef INK_ENABLE_MMAP
+	if (_mapped_length > 0)
+		unmap_file(_file, _mapped_length);
+#endif
 	if (_file != nullptr && _managed)
 		delete[] _file;
+	delete[] _instructions;
 
 	// clear pointers
 	_file             = nullptr;
 	_instruction_data = nullptr;
+	_instructions     = nullptr;
 	_string_table     = nullptr;
 
 	// clear out our reference block
@@ -192,8 +285,12 @@ globals story_impl::new_globals_from_snapshot(const snapshot& data)
 	}
 	auto* globs = new globals_impl(this);
 	snapshot.strings().clear();
-	snapshot_interface::loader loader(snapshot.strings(), _string_table, snapshot.can_be_migrated());
-	auto                       end = globs->snap_load(snapshot.get_globals_snap(), loader);
+	snapshot_interface::loader loader(
+	    snapshot.strings(), _string_table, snapshot.can_be_migrated(), snapshot.compact(),
+	    snapshot.async_state()
+	);
+	loader.instructions = instructions();
+	auto end            = globs->snap_load(snapshot.get_globals_snap(), loader);
 	inkAssert(end == snapshot.get_runner_snap(0), "not all data were used for global reconstruction");
 	if (hash() != snapshot.hash()) {
 		globals new_globs = new_globals();
@@ -209,6 +306,24 @@ globals story_impl::new_globals_from_snapshot(const snapshot& data)
 	return globals(globs, _block);
 }
 
+config::statistics::story story_impl::statistics() const
+{
+	return {
+	    static_cast<int>(_num_instructions),
+	    _instructions ? static_cast<int>(_num_instructions * sizeof(instruction)) : 0,
+	};
+}
+
+void story_impl::internal_bind(hash_t name, internal::function_base* function)
+{
+	// runners keep pointers to the shared functions, so they can not be replaced
+	inkAssert(
+	    _functions.find(name) == nullptr, "External function %u is already bound to the story",
+	    name
+	);
+	_functions.add(name, function);
+}
+
 runner story_impl::new_runner(globals store)
 {
 	if (store == nullptr)
@@ -216,6 +331,51 @@ runner story_impl::new_runner(globals store)
 	return runner(new runner_impl(this, store), _block);
 }
 
+runner story_impl::manage_runner(runner_impl* thread) const { return runner(thread, _block); }
+
+runner story_impl::acquire_runner(globals store)
+{
+	runner_impl* thread = nullptr;
+	{
+#ifdef INK_ENABLE_THREADS
+		std::lock_guard<std::mutex> lock(_runner_pool_lock);
+#endif
+		if (_runner_pool.size() > 0) {
+			thread = _runner_pool.back();
+			_runner_pool.resize(_runner_pool.size() - 1);
+		}
+	}
+	if (thread == nullptr)
+		return new_runner(store);
+	if (store == nullptr)
+		store = new_globals();
+	thread->recycle(store);
+	return runner(thread, _block);
+}
+
+void story_impl::release_runner(runner& thread)
+{
+	runner_interface* released = thread.release_unique();
+	if (released == nullptr) {
+		// still in use elsewhere
+		thread = nullptr;
+		return;
+	}
+	runner_impl* impl = static_cast<runner_impl*>(released);
+	impl->detach();
+	{
+#ifdef INK_ENABLE_THREADS
+		std::lock_guard<std::mutex> lock(_runner_pool_lock);
+#endif
+		if (_runner_pool.size() < _runner_pool.capacity()) {
+			_runner_pool.push() = impl;
+			return;
+		}
+	}
+	// pool is full
+	delete impl;
+}
+
 runner story_impl::new_runner_from_snapshot(const snapshot& data, globals store, unsigned idx)
 {
 	const snapshot_impl& snapshot = reinterpret_cast<const snapshot_impl&>(data);
@@ -229,11 +389,14 @@ runner story_impl::new_runner_from_snapshot(const snapshot& data, globals store,
 	    snapshot.strings(),
 	    _string_table,
 	    snapshot.can_be_migrated(),
+	    snapshot.compact(),
+	    snapshot.async_state(),
 	};
-	auto end = run->snap_load(snapshot.get_runner_snap(idx), loader);
+	loader.instructions = instructions();
+	auto end            = run->snap_load(snapshot.get_runner_snap(idx), loader);
 	inkAssert(
 	    (idx + 1 < snapshot.num_runners() && end == snapshot.get_runner_snap(idx + 1))
-	        || end == snapshot.get_data() + snapshot.get_data_len()
+	        || end == snapshot.full_data() + snapshot.full_length()
 	        || end == snapshot.get_list_metadata(),
 	    "not all data were used for runner reconstruction"
 	);
@@ -247,11 +410,26 @@ runner story_impl::new_runner_from_snapshot(const snapshot& data, globals store,
 
 void story_impl::setup_pointers()
 {
+	inkAssert(
+	    _length >= sizeof(ink::internal::header), "Story file is too small to contain a header"
+	);
 	const ink::internal::header& header = *reinterpret_cast<const ink::internal::header*>(_file);
 	if (! header.verify()) {
 		return;
 	}
 
+	// Every section has to lie inside the file
+	const ink::internal::header::section_t sections[]
+	    = {header._strings,       header._list_meta,      header._lists,        header._containers,
+	       header._container_map, header._container_hash, header._instructions};
+	for (const auto& section : sections) {
+		inkAssert(
+		    static_cast<uint64_t>(section._start) + section._bytes <= _length,
+		    "Story file size mismatch: file ends at %u but a section ends at %u",
+		    static_cast<uint32_t>(_length), section._start + section._bytes
+		);
+	}
+
 	// Locate sections
 	if (header._strings._bytes)
 		_string_table = reinterpret_cast<const char*>(_file + header._strings._start);
@@ -297,6 +475,15 @@ void story_impl::setup_pointers()
 	    ( uint32_t ) (_instruction_data - _file) + header._instructions._bytes
 	);
 	_length = _instruction_data + header._instructions._bytes - _file;
+	_num_instructions = header._instructions._bytes / CommandSize<uint32_t>;
+
+	// Older files do not store their hash, compute it once like earlier versions did, so their
+	// snapshots still match
+	_hash = header.has_hash() ? header.hash() : hash_data_legacy(_file, _length);
+
+	if constexpr (config::predecodeInstructions) {
+		decode_instructions();
+	}
 
 	// Debugging info
 	/*{
@@ -308,4 +495,47 @@ void story_impl::setup_pointers()
 	  }
 	}*/
 }
+
+void story_impl::decode_instructions()
+{
+	_instructions = new instruction[_num_instructions];
+	for (uint32_t i = 0; i < _num_instructions; ++i) {
+		ip_t         ip  = _instruction_data + i * CommandSize<uint32_t>;
+		instruction& dec = _instructions[i];
+		dec.command      = static_cast<Command>(ip[0]);
+		dec.flag         = static_cast<CommandFlag>(ip[1]);
+		dec.container    = ~0U;
+		memcpy(&dec.value, ip + sizeof(Command) + sizeof(CommandFlag), sizeof(uint32_t));
+
+		switch (dec.command) {
+			case Command::STR:
+			case Command::TAG:
+			case Command::STR_NEWLINE: dec.string = string(dec.value); break;
+			case Command::TUNNEL:
+				if (dec.flag & CommandFlag::TUNNEL_TO_VARIABLE) {
+					break;
+				}
+				dec.container = find_container_for(dec.value);
+				dec.target    = _instruction_data + dec.value;
+				break;
+			case Command::FUNCTION:
+				if (dec.flag & CommandFlag::FUNCTION_TO_VARIABLE) {
+					break;
+				}
+				dec.container = find_container_for(dec.value);
+				dec.target    = _instruction_data + dec.value;
+				break;
+			case Command::DIVERT:
+				dec.container = find_container_for(dec.value);
+				dec.target    = _instruction_data + dec.value;
+				break;
+			case Command::CHOICE:
+				if (! find_container_id(dec.value, dec.container)) {
+					dec.container = ~0U;
+				}
+				break;
+			default: break;
+		}
+	}
+}
 } // namespace ink::runtime::internal
@@ -13,10 +13,34 @@
 #include "story.h"
 #include "header.h"
 #include "list_table.h"
+#include "functions.h"
+
+#ifdef INK_ENABLE_THREADS
+#	include <mutex>
+#endif
 
 namespace ink::runtime::internal
 {
-// Ink story. Constant once constructed. Can be shared safely between multiple runner instances
+class runner_impl;
+
+// Instruction with resolved operand, created on load if config::predecodeInstructions is set
+struct instruction {
+	Command     command;
+	CommandFlag flag;
+	// CHOICE: container starting at the choice destination
+	// DIVERT, TUNNEL, FUNCTION: innermost container of the jump target
+	// ~0 if there is none
+	container_t container;
+
+	union {
+		uint32_t    value;  // raw operand
+		const char* string; // STR, TAG, STR_NEWLINE
+		ip_t        target; // DIVERT, TUNNEL, FUNCTION
+	};
+};
+
+// Ink story. Constant once constructed, except for the runner pool. Can be shared safely between
+// multiple runner instances, with INK_ENABLE_THREADS also between runners on different threads
 class story_impl : public story
 {
 public:
@@ -26,6 +50,13 @@ public:
 	// Create story from allocated binary data in memory. If manage is true, this class will delete
 	//  the pointers on destruction
 	story_impl(const unsigned char* binary, size_t len, bool manage = true);
+#ifdef INK_ENABLE_MMAP
+	// Create story from a read-only memory mapping of a file
+	struct map_file_t {
+	};
+
+	story_impl(const char* filename, map_file_t);
+#endif
 	virtual ~story_impl();
 
 	const char* string(uint32_t index) const;
@@ -34,6 +65,14 @@ public:
 
 	inline ip_t end() const { return _file + _length; }
 
+	// decoded instruction at ip, only available with config::predecodeInstructions
+	inline const instruction& decoded(ip_t ip) const
+	{
+		size_t index = static_cast<size_t>(ip - _instruction_data) / CommandSize<uint32_t>;
+		inkAssert(index < _num_instructions, "Unexpected EOF in Ink execution");
+		return _instructions[index];
+	}
+
 	inline uint32_t num_containers() const { return _num_containers; }
 
 	const list_flag* lists() const { return _lists; }
@@ -81,16 +120,33 @@ public:
 	virtual runner  new_runner(globals store = nullptr) override;
 	virtual runner
 	    new_runner_from_snapshot(const snapshot&, globals store = nullptr, unsigned idx = 0) override;
+	virtual runner acquire_runner(globals store = nullptr) override;
+	virtual void   release_runner(runner& thread) override;
+
+	// hands out a runner created outside of new_runner
+	runner manage_runner(runner_impl* thread) const;
 
-	hash_t hash() const override { return hash_data(_file, _length); }
+	hash_t hash() const override { return _hash; }
+
+	config::statistics::story statistics() const override;
+
+	// functions bound for all runners
+	const functions& shared_functions() const { return _functions; }
+
+protected:
+	virtual void internal_bind(hash_t name, internal::function_base* function) override;
 
 private:
 	void setup_pointers();
 
+	// decode instruction section into _instructions
+	void decode_instructions();
+
 private:
 	// file information
 	const unsigned char* _file;
 	size_t               _length;
+	hash_t               _hash = 0;
 
 	// string table
 	const char* _string_table = nullptr;
@@ -112,12 +168,28 @@ private:
 	uint32_t                _container_hash_size = 0;
 
 	// instruction info
-	ip_t _instruction_data = nullptr;
+	ip_t     _instruction_data = nullptr;
+	uint32_t _num_instructions = 0;
+
+	// decoded instructions
+	instruction* _instructions = nullptr;
 
 	// story block used to create various weak pointers
 	ref_block* _block;
 
+	// functions bound for all runners, runners cache them in their own registry
+	functions _functions;
+
+	// released runners, handed out again by acquire_runner
+	managed_array<runner_impl*, false, config::limitRunnerPool, true> _runner_pool;
+#ifdef INK_ENABLE_THREADS
+	std::mutex _runner_pool_lock;
+#endif
+
 	// whether we need to delete our binary data after we destruct
 	bool _managed;
+
+	// length of the file mapping _file points into, 0 if the file is not mapped
+	size_t _mapped_length = 0;
 };
 } // namespace ink::runtime::internal
@@ -13,16 +13,12 @@ void ref_block::remove_reference(ref_block*& block)
 	if (block == nullptr)
 		return;
 
-	// If we only have one references left
-	if (block->references <= 1) {
-		// delete the block
+	// Decrement references, if this was the last one delete the block. Decrement and check are one
+	// step, so only one thread sees the last reference go.
+	if (block->references-- <= 1) {
 		delete block;
 		block = nullptr;
-		return;
 	}
-
-	// Otherwise, decrement references
-	block->references--;
 }
 
 story_ptr_base::story_ptr_base(internal::ref_block* story)
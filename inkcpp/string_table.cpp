@@ -11,10 +11,91 @@ namespace ink::runtime::internal
 {
 string_table::~string_table()
 {
-	// Delete all allocated strings
-	for (auto iter = _table.begin(); iter != _table.end(); ++iter)
-		delete[] iter.key();
-	_table.clear();
+	// Strings live in the pages, no need to visit them one by one
+	for (page* p : _pages) {
+		delete[] reinterpret_cast<char*>(p);
+	}
+	if (_spare != nullptr) {
+		delete[] reinterpret_cast<char*>(_spare);
+	}
+}
+
+string_table::entry* string_table::entry_of(const char* string)
+{
+	return reinterpret_cast<entry*>(const_cast<char*>(string)) - 1;
+}
+
+const char* string_table::string_of(const entry* e) { return reinterpret_cast<const char*>(e + 1); }
+
+string_table::page* string_table::new_page(size_t capacity)
+{
+	page* p;
+	if (capacity == PageSize && _spare != nullptr) {
+		p      = _spare;
+		_spare = nullptr;
+	} else {
+		p = reinterpret_cast<page*>(new char[sizeof(page) + capacity]);
+		if (p == nullptr)
+			return nullptr;
+	}
+	p->capacity = capacity;
+	p->used     = 0;
+	p->live     = 0;
+
+	// keep the index sorted by address
+	size_t pos = _pages.size();
+	while (pos > 0 && _pages[pos - 1] > p) {
+		--pos;
+	}
+	_pages.insert(pos) = p;
+	return p;
+}
+
+void string_table::delete_page(page* p)
+{
+	// keep one regular page around, strings get created and collected every line
+	if (_spare == nullptr && p->capacity == PageSize) {
+		_spare = p;
+		return;
+	}
+	delete[] reinterpret_cast<char*>(p);
+}
+
+string_table::page* string_table::find_page(const char* string) const
+{
+	// binary search for the last page starting before the string
+	size_t begin = 0;
+	size_t end   = _pages.size();
+	while (begin < end) {
+		size_t mid = begin + (end - begin) / 2;
+		if (reinterpret_cast<const char*>(_pages[mid]) < string) {
+			begin = mid + 1;
+		} else {
+			end = mid;
+		}
+	}
+	if (begin == 0) {
+		return nullptr;
+	}
+	page* p = _pages[begin - 1];
+	if (string < p->data() || string >= p->data() + p->used) {
+		return nullptr;
+	}
+	return p;
+}
+
+template<typename F>
+void string_table::for_each(F f) const
+{
+	for (page* p : _pages) {
+		for (size_t offset = 0; offset < p->used;) {
+			entry* e = reinterpret_cast<entry*>(p->data() + offset);
+			offset += slot_size(e->length);
+			if (e->live) {
+				f(*e);
+			}
+		}
+	}
 }
 
 char* string_table::duplicate(const char* str)
@@ -34,95 +115,125 @@ char* string_table::duplicate(const char* str)
 
 char* string_table::create(size_t length)
 {
-	// allocate the string
-	/// @todo use continuous memory
-	char* data = new char[length];
-	if (data == nullptr)
-		return nullptr;
+	// every string needs its own address to be found in the table
+	if (length == 0) {
+		length = 1;
+	}
 
-	// Add to the tree
-	bool success = _table.insert(data, true); // TODO: Should it start as used?
+	bool success = config::limitStringTable < 0
+	            || _count < static_cast<size_t>(abs(config::limitStringTable));
 	inkAssert(success, "String table is full, unable to add new data.");
 	if (! success) {
-		delete[] data;
 		return nullptr;
 	}
 
+	// find a page with enough room
+	const size_t size = slot_size(length);
+	page*        p    = _current;
+	if (p == nullptr || p->capacity - p->used < size) {
+		if (length > PageSize / 4) {
+			// large strings get a page on their own, to not waste the rest of the current one
+			p = new_page(size);
+		} else {
+			p        = new_page(PageSize);
+			_current = p;
+		}
+		if (p == nullptr)
+			return nullptr;
+	}
+
+	// carve out the string
+	entry* e  = reinterpret_cast<entry*>(p->data() + p->used);
+	e->length = static_cast<uint32_t>(length);
+	e->used   = true; // TODO: Should it start as used?
+	e->live   = true;
+	p->used += size;
+	p->live += 1;
+	_count += 1;
+	_live_bytes += length;
+	_created += 1;
+	_ids_valid = false;
+
 	// Return allocated string
-	return data;
+	return const_cast<char*>(string_of(e));
 }
 
 void string_table::clear_usage()
 {
 	// Clear usages
-	for (auto iter = _table.begin(); iter != _table.end(); ++iter)
-		iter.val() = false;
+	for_each([](entry& e) { e.used = false; });
 }
 
 void string_table::mark_used(const char* string)
 {
-	auto iter = _table.find(string);
-	if (iter == _table.end())
+	// strings from the story are never in the table
+	if (find_page(string) == nullptr)
 		return; // assert??
 
 	// set used flag
-	*iter = true;
+	entry_of(string)->used = true;
 }
 
-void string_table::gc()
+size_t string_table::gc()
 {
-	// begin at the start
-	auto iter = _table.begin();
+	size_t freed = 0;
+	_created     = 0;
 
-	const char* last = nullptr;
-	while (iter != _table.end()) {
-		// If the string is not used
-		if (! *iter) {
-			// Delete it
-			delete[] iter.key();
-			_table.erase(iter);
-
-			// Re-establish iterator at last position
-			// TODO: BAD. We need inline delete that doesn't invalidate pointers
-			if (last == nullptr)
-				iter = _table.begin();
-			else {
-				iter = _table.find(last);
-				iter++;
+	// Sweep page by page, dropping pages without strings left on the way
+	size_t kept = 0;
+	for (size_t i = 0; i < _pages.size(); ++i) {
+		page* p = _pages[i];
+		for (size_t offset = 0; offset < p->used;) {
+			entry* e = reinterpret_cast<entry*>(p->data() + offset);
+			offset += slot_size(e->length);
+			if (e->live && ! e->used) {
+				e->live = false;
+				p->live -= 1;
+				_live_bytes -= e->length;
+				++freed;
 			}
+		}
 
+		// the current page is only rewound
+		if (p->live == 0 && p == _current) {
+			p->used = 0;
+		} else if (p->live == 0) {
+			delete_page(p);
 			continue;
 		}
-
-		// Next
-		last = iter.key();
-		iter++;
+		_pages[kept++] = p;
 	}
+	_pages.resize(kept);
+	_count -= freed;
+	_ids_valid = _ids_valid && freed == 0;
+	return freed;
 }
 
-size_t string_table::snap(unsigned char* data, const snapper&) const
+size_t string_table::snap(unsigned char* data, const snapper& snapper) const
 {
+	if (snapper.compact) {
+		return snap_compact(data);
+	}
 	unsigned char* ptr          = data;
 	bool           should_write = data != nullptr;
-	for (size_t i = 0; i < _table.size(); ++i) {
-		for (auto itr = _table.begin(); itr != _table.end(); ++itr) {
-			if (itr.temp_identifier() == i) {
-				size_t length = static_cast<size_t>(strlen(itr.key())) + 1;
-				if (length == 1) {
-					ptr = snap_write(ptr, EMPTY_STRING, 2, should_write);
-				} else {
-					ptr = snap_write(ptr, itr.key(), length, should_write);
-				}
-				break;
-			}
+	for_each([&ptr, should_write](const entry& e) {
+		const char* str    = string_of(&e);
+		size_t      length = static_cast<size_t>(strlen(str)) + 1;
+		if (length == 1) {
+			ptr = snap_write(ptr, EMPTY_STRING, 2, should_write);
+		} else {
+			ptr = snap_write(ptr, str, length, should_write);
 		}
-	}
+	});
 	ptr = snap_write(ptr, "\0", 1, should_write);
 	return static_cast<size_t>(ptr - data);
 }
 
 const unsigned char* string_table::snap_load(const unsigned char* data, const loader& loader)
 {
+	if (loader.compact) {
+		return snap_load_compact(data, loader);
+	}
 	auto* ptr = data;
 	while (*ptr) {
 		size_t len = 0;
@@ -139,17 +250,112 @@ const unsigned char* string_table::snap_load(const unsigned char* data, const lo
 	return ptr + 1;
 }
 
+// The compact format starts with the number of strings. Each string is stored as its length
+// shifted left by one followed by the bytes, or if the same text was already written, as the id
+// of that string shifted left by one with the lowest bit set.
+size_t string_table::snap_compact(unsigned char* data) const
+{
+	unsigned char* ptr          = data;
+	bool           should_write = data != nullptr;
+	size_t         count        = 0;
+	for_each([&count](const entry&) { ++count; });
+	ptr = snap_write_varint(ptr, count, should_write);
+	if (count == 0) {
+		return static_cast<size_t>(ptr - data);
+	}
+
+	// open addressing table of ids + 1, keyed by the hash of the text
+	size_t size = 1;
+	while (size < 2 * count) {
+		size *= 2;
+	}
+	const size_t mask    = size - 1;
+	uint32_t*    slots   = new uint32_t[size]{};
+	const char** strings = new const char*[count];
+	uint32_t     id      = 0;
+	for_each([&](const entry& e) {
+		const char* str    = string_of(&e);
+		size_t      length = static_cast<size_t>(strlen(str));
+		for (size_t i = hash_data(reinterpret_cast<const unsigned char*>(str), length) & mask;;
+		     i        = (i + 1) & mask) {
+			if (slots[i] == 0) {
+				slots[i] = id + 1;
+				ptr      = snap_write_varint(ptr, static_cast<uint64_t>(length) << 1, should_write);
+				ptr      = snap_write(ptr, str, length, should_write);
+				break;
+			}
+			if (strcmp(strings[slots[i] - 1], str) == 0) {
+				ptr = snap_write_varint(ptr, (static_cast<uint64_t>(slots[i] - 1) << 1) | 1, should_write);
+				break;
+			}
+		}
+		strings[id++] = str;
+	});
+	delete[] strings;
+	delete[] slots;
+	return static_cast<size_t>(ptr - data);
+}
+
+const unsigned char* string_table::snap_load_compact(const unsigned char* ptr, const loader& loader)
+{
+	const size_t first = loader.string_table.size();
+	uint64_t     count;
+	ptr = snap_read_varint(ptr, count);
+	for (uint64_t n = 0; n < count; ++n) {
+		uint64_t tag;
+		ptr = snap_read_varint(ptr, tag);
+		char* str;
+		if (tag & 1) {
+			size_t original = first + static_cast<size_t>(tag >> 1);
+			inkAssert(original < loader.string_table.size(), "Corrupted string table in snapshot.");
+			str = duplicate(loader.string_table[original]);
+		} else {
+			size_t length = static_cast<size_t>(tag >> 1);
+			str           = create(length + 1);
+			ptr           = snap_read(ptr, str, length);
+			str[length]   = 0;
+		}
+		loader.string_table.push() = str;
+	}
+	return ptr;
+}
+
+void string_table::assign_ids() const
+{
+	uint32_t id = 0;
+	for_each([&id](entry& e) { e.id = id++; });
+	_ids_valid = true;
+}
+
 size_t string_table::get_id(const char* string) const
 {
-	auto iter = _table.find(string);
-	inkAssert(iter != _table.end(), "Try to fetch not contained string!");
-	return iter.temp_identifier();
+	inkAssert(find_page(string) != nullptr, "Try to fetch not contained string!");
+	if (! _ids_valid) {
+		assign_ids();
+	}
+	return entry_of(string)->id;
+}
+
+void string_table::list(managed_array<const char*, true, 5>& strings) const
+{
+	strings.clear();
+	for_each([&strings](const entry& e) { strings.push() = string_of(&e); });
 }
 
 config::statistics::string_table string_table::statistics() const
 {
+	size_t reserved = 0;
+	for (const page* p : _pages) {
+		reserved += p->capacity;
+	}
+	// the unused end of the current page is still available
+	size_t available = _current ? _current->capacity - _current->used : 0;
+	size_t limit     = config::limitStringTable > 0 ? static_cast<size_t>(config::limitStringTable) : _count;
 	return config::statistics::string_table{
-	    {static_cast<int>(_table.max_size()), static_cast<int>(_table.size())},
+	    {static_cast<int>(limit), static_cast<int>(_count)},
+	    static_cast<int>(_pages.size() + (_spare ? 1 : 0)),
+	    static_cast<int>(_live_bytes),
+	    static_cast<int>(reserved - available - _live_bytes),
 	};
 }
 
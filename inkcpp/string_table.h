@@ -6,14 +6,14 @@
  */
 #pragma once
 
-#include "avl_array.h"
+#include "array.h"
 #include "config.h"
 #include "system.h"
 #include "snapshot_impl.h"
 
 namespace ink::runtime::internal
 {
-// hash tree sorted by string pointers
+// strings carved out of pages, each with a small header in front of it
 class string_table final : public snapshot_interface
 {
 public:
@@ -40,15 +40,79 @@ public:
 	// used to enable storing a string table references
 	size_t get_id(const char* string) const;
 
-	// deletes all unused strings
-	void gc();
+	// lists all strings in the order of their ids, to resolve ids without a snapshot
+	void list(managed_array<const char*, true, 5>& strings) const;
+
+	// deletes all unused strings, returns the number of deleted strings
+	size_t gc();
+
+	// number of strings created since the last gc
+	size_t created() const { return _created; }
+
+	// true if a limited table is half full, unlimited tables only grow pages
+	bool nearly_full() const
+	{
+		return config::limitStringTable > 0
+		    && _count * 2 >= static_cast<size_t>(config::limitStringTable);
+	}
 
 	/** Get usage statistics for the string_table. */
 	config::statistics::string_table statistics() const;
 
 private:
-	avl_array < const char*, bool, ink::size_t,
-	    config::limitStringTable<0, abs(config::limitStringTable)> _table;
-	static constexpr const char*                                   EMPTY_STRING = "\x03";
+	// Strings are carved out of pages, a page is freed as soon as none of its strings is used
+	struct page {
+		size_t capacity; // bytes following the header
+		size_t used;     // bytes handed out
+		size_t live;     // number of strings still in the table
+
+		char* data() { return reinterpret_cast<char*>(this + 1); }
+	};
+
+	// placed in front of every string, so lookups and sweeps do not need a separate index
+	struct entry {
+		uint32_t length; // bytes of the string, including the terminator
+		uint32_t id;     // position in the snapshot, see assign_ids()
+		bool     used;
+		bool     live; // false once collected, the bytes stay until the page is freed
+	};
+
+	static constexpr size_t PageSize = static_cast<size_t>(config::stringTablePageSize);
+
+	// bytes taken by a string of length inside a page, keeps the next entry aligned
+	static constexpr size_t slot_size(size_t length)
+	{
+		return sizeof(entry) + (length + alignof(entry) - 1) / alignof(entry) * alignof(entry);
+	}
+
+	static entry*       entry_of(const char* string);
+	static const char*  string_of(const entry* e);
+
+	page* new_page(size_t capacity);
+	void  delete_page(page* p);
+	// page containing string, nullptr if it was not created by this table
+	page* find_page(const char* string) const;
+	// numbers live strings in the order snap() writes them
+	void  assign_ids() const;
+
+	// snapshot format version 2, with repeated strings stored once
+	size_t               snap_compact(unsigned char* data) const;
+	const unsigned char* snap_load_compact(const unsigned char* data, const loader&);
+
+	// calls f(entry&) for all strings still in the table in snapshot order
+	template<typename F>
+	void for_each(F f) const;
+
+	static constexpr const char* EMPTY_STRING = "\x03";
+
+	// all pages sorted by address, to find the page of a string
+	managed_array<page*, true, 8, true> _pages;
+
+	page*        _current    = nullptr; // page filled next
+	page*        _spare      = nullptr; // emptied page kept to avoid reallocation
+	size_t       _count      = 0;
+	size_t       _live_bytes = 0;
+	size_t       _created    = 0;
+	mutable bool _ids_valid  = false;
 };
 } // namespace ink::runtime::internal
@@ -21,12 +21,12 @@ namespace ink::runtime::internal
 inline int toStr(char* buffer, size_t size, uint32_t value)
 {
 #ifdef WIN32
-	return _itoa_s(static_cast<int>(value), buffer, size, 10);
+	return _ultoa_s(value, buffer, size, 10);
 #else
 	if (buffer == nullptr || size < 1) {
 		return EINVAL;
 	}
-	int res = snprintf(buffer, size, "%d", value);
+	int res = snprintf(buffer, size, "%u", value);
 	if (res > 0 && static_cast<size_t>(res) < size) {
 		return 0;
 	}
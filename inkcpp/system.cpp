@@ -5,6 +5,7 @@
  * https://github.com/JBenda/inkcpp for full license details.
  */
 #include "system.h"
+#include "platform.h"
 
 #ifndef INK_ENABLE_UNREAL
 
@@ -25,13 +26,43 @@ hash_t hash_string(const char* string)
 	return h; // or return h % C;
 }
 
+static constexpr uint64_t K = 0x9E3779B97F4A7C15ull; // 2^64 / golden ratio
+
+static inline uint64_t hash_word(uint64_t h, uint64_t word)
+{
+	return (((h << 5) | (h >> 59)) ^ word) * K;
+}
+
 hash_t hash_data(const unsigned char* data, size_t len)
+{
+	uint64_t h = FIRSTH ^ (static_cast<uint64_t>(len) * K);
+
+	size_t i = 0;
+	for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+		uint64_t word;
+		memcpy(&word, data + i, sizeof(word));
+		h = hash_word(h, word);
+	}
+	if (i < len) {
+		uint64_t word = 0;
+		memcpy(&word, data + i, len - i);
+		h = hash_word(h, word);
+	}
+
+	// fold the well mixed high bits into the result
+	h ^= h >> 29;
+	h *= K;
+	h ^= h >> 32;
+	return static_cast<hash_t>(h);
+}
+
+hash_t hash_data_legacy(const unsigned char* data, size_t len)
 {
 	hash_t h = FIRSTH;
 	for (size_t i = 0; i < len; ++i) {
 		h = (h * A) ^ (data[i] * B);
 	}
-	return h; // or return h % C;
+	return h;
 }
 
 namespace internal
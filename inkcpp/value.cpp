@@ -249,7 +249,46 @@ size_t value::snap(unsigned char* data, const snapper& snapper) const
 {
 	unsigned char* ptr          = data;
 	bool           should_write = data != nullptr;
-	ptr                         = snap_write(ptr, _type, should_write);
+	ptr                         = snap_write(ptr, _type, should_write, snapper);
+	if (snapper.compact) {
+		// only the member used by the type
+		switch (_type) {
+			case value_type::boolean: ptr = snap_write(ptr, bool_value, should_write); break;
+			case value_type::divert:
+			case value_type::uint32:
+			case value_type::thread_end:
+				ptr = snap_write(ptr, uint32_value, should_write, snapper);
+				break;
+			case value_type::int32: ptr = snap_write(ptr, int32_value, should_write, snapper); break;
+			case value_type::float32: ptr = snap_write(ptr, float_value, should_write); break;
+			case value_type::list: ptr = snap_write(ptr, list_value, should_write, snapper); break;
+			case value_type::list_flag:
+				ptr = snap_write(ptr, list_flag_value.list_id, should_write);
+				ptr = snap_write(ptr, list_flag_value.flag, should_write);
+				break;
+			case value_type::string: {
+				ptr       = snap_write(ptr, string_value.allocated, should_write);
+				size_t id = string_value.allocated
+				              ? snapper.strings.get_id(string_value.str)
+				              : static_cast<size_t>(string_value.str - snapper.story_string_table);
+				ptr       = snap_write(ptr, id, should_write, snapper);
+			} break;
+			case value_type::value_pointer:
+				ptr = snap_write(ptr, pointer.name, should_write);
+				ptr = snap_write(ptr, pointer.ci, should_write, snapper);
+				break;
+			case value_type::jump_marker:
+			case value_type::thread_start: ptr = snap_write(ptr, jump, should_write, snapper); break;
+			case value_type::tunnel_frame:
+			case value_type::function_frame:
+			case value_type::thread_frame:
+				ptr = snap_write(ptr, frame_value.addr, should_write, snapper);
+				ptr = snap_write(ptr, frame_value.eval, should_write);
+				break;
+			default: break;
+		}
+		return static_cast<size_t>(ptr - data);
+	}
 	if (_type == value_type::string) {
 		unsigned char buf[max_value_size];
 		string_type*  res = reinterpret_cast<string_type*>(buf);
@@ -274,7 +313,43 @@ size_t value::snap(unsigned char* data, const snapper& snapper) const
 
 const unsigned char* value::snap_load(const unsigned char* ptr, const loader& loader)
 {
-	ptr = snap_read(ptr, _type);
+	ptr = snap_read(ptr, _type, loader);
+	if (loader.compact) {
+		switch (_type) {
+			case value_type::boolean: ptr = snap_read(ptr, bool_value); break;
+			case value_type::divert:
+			case value_type::uint32:
+			case value_type::thread_end: ptr = snap_read(ptr, uint32_value, loader); break;
+			case value_type::int32: ptr = snap_read(ptr, int32_value, loader); break;
+			case value_type::float32: ptr = snap_read(ptr, float_value); break;
+			case value_type::list: ptr = snap_read(ptr, list_value, loader); break;
+			case value_type::list_flag:
+				ptr = snap_read(ptr, list_flag_value.list_id);
+				ptr = snap_read(ptr, list_flag_value.flag);
+				break;
+			case value_type::string: {
+				size_t id;
+				ptr = snap_read(ptr, string_value.allocated);
+				ptr = snap_read(ptr, id, loader);
+				string_value.str = string_value.allocated ? loader.string_table[id]
+				                                          : loader.story_string_table + id;
+			} break;
+			case value_type::value_pointer:
+				ptr = snap_read(ptr, pointer.name);
+				ptr = snap_read(ptr, pointer.ci, loader);
+				break;
+			case value_type::jump_marker:
+			case value_type::thread_start: ptr = snap_read(ptr, jump, loader); break;
+			case value_type::tunnel_frame:
+			case value_type::function_frame:
+			case value_type::thread_frame:
+				ptr = snap_read(ptr, frame_value.addr, loader);
+				ptr = snap_read(ptr, frame_value.eval);
+				break;
+			default: break;
+		}
+		return ptr;
+	}
 	ptr = snap_read(ptr, &bool_value, max_value_size);
 	if (_type == value_type::string) {
 		if (string_value.allocated) {
@@ -78,6 +78,12 @@ typedef struct HInkSTory    HInkStory;
 	 */
 	HInkSnapshot*
 	     ink_snapshot_from_binary(const unsigned char* data, size_t length, bool freeOnDestroy);
+	/** @memberof HInkSnapshot
+	 *  @copydoc ink::runtime::snapshot::from_delta()
+	 */
+	HInkSnapshot* ink_snapshot_from_delta(
+	    const HInkSnapshot* base, const unsigned char* data, size_t length
+	);
 	/** @memberof HInkSnapshot
 	 *  @copydoc  ink::runtime::snapshot::num_runners()
 	 *  @param self
@@ -233,6 +239,13 @@ typedef struct HInkSTory    HInkStory;
 	 * @return value to be furthe process by the ink runtime
 	 */
 	typedef void (*InkExternalFunctionVoid)(int argc, const InkValue argv[]);
+	/** @memberof HInkRunner
+	 * Callback receiving a line piece by piece
+	 * @param context pointer passed to ink_runner_stream_line()
+	 * @param text start of the span, not null terminated and only valid during the call
+	 * @param length number of characters in the span
+	 */
+	typedef void (*InkLineSink)(void* context, const char* text, size_t length);
 
 	/** @class HInkRunner
 	 * @ingroup clib
@@ -250,6 +263,12 @@ typedef struct HInkSTory    HInkStory;
 	 * @ref ::HInkSnapshot
 	 */
 	HInkSnapshot*     ink_runner_create_snapshot(const HInkRunner* self);
+	/** @memberof HInkRunner
+	 * Creates a snapshot only containing the changes since @p base.
+	 * @sa ink_snapshot_from_delta()
+	 */
+	HInkSnapshot*
+	    ink_runner_create_delta_snapshot(const HInkRunner* self, const HInkSnapshot* base);
 	/** @memberof HInkRunner
 	 * @copydoc ink::runtime::runner_interface::can_continue()
 	 */
@@ -258,6 +277,16 @@ typedef struct HInkSTory    HInkStory;
 	 * @copydoc ink::runtime::runner_interface::getline_alloc()
 	 */
 	const char*       ink_runner_get_line(HInkRunner* self);
+	/** @memberof HInkRunner
+	 * @copydoc ink::runtime::runner_interface::getline(char*,size_t)
+	 * @param self
+	 */
+	size_t            ink_runner_get_line_into(HInkRunner* self, char* buffer, size_t size);
+	/** @memberof HInkRunner
+	 * @copydoc ink::runtime::runner_interface::stream_line(line_sink,void*)
+	 * @param self
+	 */
+	void ink_runner_stream_line(HInkRunner* self, InkLineSink sink, void* context);
 	/** @memberof HInkRunner
 	 * @copydoc ink::runtime::runner_interface::num_tags()
 	 */
@@ -374,6 +403,12 @@ typedef struct HInkSTory    HInkStory;
 	 * @ref ::HInkSnapshot
 	 */
 	HInkSnapshot* ink_globals_create_snapshot(const HInkGlobals* self);
+	/** @memberof HInkGlobals
+	 * Creates a snapshot only containing the changes since @p base.
+	 * @sa ink_snapshot_from_delta()
+	 */
+	HInkSnapshot*
+	    ink_globals_create_delta_snapshot(const HInkGlobals* self, const HInkSnapshot* base);
 	/** @memberof HInkGlobals
 	 * assignes a observer to the variable with the corresponding name.
 	 * The observer is called each time the value of the variable gets assigned.
@@ -415,6 +450,12 @@ typedef struct HInkSTory    HInkStory;
 	 * @copydoc ink::runtime::story::from_binary()
 	 */
 	HInkStory*   ink_story_from_binary(const unsigned char* data, size_t length, bool freeOnDestroy);
+	/** @memberof HInkStory
+	 *  @copydoc ink::runtime::story::from_mmap()
+	 *  @attention only supported on platforms with memory mapped files, returns NULL otherwise.
+	 *  @sa ink_story_from_file()
+	 */
+	HInkStory*   ink_story_from_mmap(const char* filename);
 	/** @memberof HInkStory
 	 * deletes a story and all assoziated resources
 	 * @param self
@@ -93,6 +93,16 @@ extern "C" {
 		return reinterpret_cast<HInkStory*>(story::from_binary(data, file_length));
 	}
 
+	HInkStory* ink_story_from_mmap(const char* filename)
+	{
+#	ifdef INK_ENABLE_MMAP
+		return reinterpret_cast<HInkStory*>(story::from_mmap(filename));
+#	else
+		fprintf(stderr, "Memory mapped files are not supported, can not map: %s\n", filename);
+		return NULL;
+#	endif
+	}
+
 	HInkSnapshot* ink_snapshot_from_file(const char* filename)
 	{
 		FILE* file = fopen(filename, "rb");
@@ -142,6 +152,14 @@ extern "C" {
 		);
 	}
 
+	HInkSnapshot*
+	    ink_snapshot_from_delta(const HInkSnapshot* base, const unsigned char* data, size_t length)
+	{
+		return reinterpret_cast<HInkSnapshot*>(snapshot::from_delta(
+		    *reinterpret_cast<const snapshot*>(base), data, static_cast<ink::size_t>(length)
+		));
+	}
+
 	void ink_snapshot_get_binary(
 	    const HInkSnapshot* self, const unsigned char** data, size_t* data_length
 	)
@@ -231,6 +249,15 @@ extern "C" {
 		);
 	}
 
+	HInkSnapshot* ink_runner_create_delta_snapshot(const HInkRunner* self, const HInkSnapshot* base)
+	{
+		return reinterpret_cast<HInkSnapshot*>(
+		    reinterpret_cast<const runner*>(self)->get()->create_delta_snapshot(
+		        *reinterpret_cast<const snapshot*>(base)
+		    )
+		);
+	}
+
 	int ink_runner_can_continue(const HInkRunner* self)
 	{
 		return reinterpret_cast<const runner*>(self)->get()->can_continue();
@@ -241,6 +268,18 @@ extern "C" {
 		return reinterpret_cast<runner*>(self)->get()->getline_alloc();
 	}
 
+	size_t ink_runner_get_line_into(HInkRunner* self, char* buffer, size_t size)
+	{
+		return reinterpret_cast<runner*>(self)->get()->getline(buffer, size);
+	}
+
+	void ink_runner_stream_line(HInkRunner* self, InkLineSink sink, void* context)
+	{
+		reinterpret_cast<runner*>(self)->get()->stream_line(
+		    [sink, context](const char* text, size_t length) { sink(context, text, length); }
+		);
+	}
+
 	int ink_runner_num_tags(const HInkRunner* self)
 	{
 		return reinterpret_cast<const runner*>(self)->get()->num_tags();
@@ -349,6 +388,16 @@ extern "C" {
 		);
 	}
 
+	HInkSnapshot*
+	    ink_globals_create_delta_snapshot(const HInkGlobals* self, const HInkSnapshot* base)
+	{
+		return reinterpret_cast<HInkSnapshot*>(
+		    reinterpret_cast<const globals*>(self)->get()->create_delta_snapshot(
+		        *reinterpret_cast<const snapshot*>(base)
+		    )
+		);
+	}
+
 	constexpr InkValue ink_value_none()
 	{
 		InkValue value{};
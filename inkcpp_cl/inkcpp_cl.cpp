@@ -41,6 +41,22 @@ std::ostream& operator<<(std::ostream& os, const ink::config::statistics::string
 	os << "\n";
 	depth += 1;
 	os << std::string(depth, '\t') << "string_refs" << st.string_refs << "\n";
+	os << std::string(depth, '\t') << "pages " << st.pages << "\n";
+	os << std::string(depth, '\t') << "bytes_live " << st.bytes_live << "\n";
+	os << std::string(depth, '\t') << "bytes_wasted " << st.bytes_wasted << "\n";
+	depth -= 1;
+	return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const ink::config::statistics::gc& gc)
+{
+	os << "\n";
+	depth += 1;
+	os << std::string(depth, '\t') << "collections " << gc.collections << "\n";
+	os << std::string(depth, '\t') << "skipped " << gc.skipped << "\n";
+	os << std::string(depth, '\t') << "strings_freed " << gc.strings_freed << "\n";
+	os << std::string(depth, '\t') << "lists_freed " << gc.lists_freed << "\n";
+	os << std::string(depth, '\t') << "time_us " << gc.time_us << "\n";
 	depth -= 1;
 	return os;
 }
@@ -69,6 +85,17 @@ std::ostream& operator<<(std::ostream& os, const ink::config::statistics::global
 	os << std::string(depth, '\t') << "variables_observers" << g.variables_observers << "\n";
 	os << std::string(depth, '\t') << "lists" << g.lists;
 	os << std::string(depth, '\t') << "strings" << g.strings;
+	os << std::string(depth, '\t') << "garbage_collection" << g.garbage_collection;
+	depth -= 1;
+	return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const ink::config::statistics::story& s)
+{
+	os << "\n";
+	depth += 1;
+	os << std::string(depth, '\t') << "instructions " << s.instructions << "\n";
+	os << std::string(depth, '\t') << "decoded_instructions " << s.decoded_instructions << "\n";
 	depth -= 1;
 	return os;
 }
@@ -83,7 +110,8 @@ void usage()
 	     << "\t--ommit-choice-tags:\tdo not print tags after choices, primarly used to be compatible "
 	        "with inkclecat output"
 	     << "\t--inklecate <path-to-inklecate>:\toverwrites INKLECATE enviroment variable\n"
-	     << "\t--statistics:\tprints memory statistics before each choice\n"
+	     << "\t--statistics:\tprints the number of compiled instructions per command, memory "
+	        "statistics and snapshot sizes before each choice\n"
 	     << endl;
 }
 
@@ -172,6 +200,12 @@ int main(int argc, const char** argv)
 			for (auto& err : results.errors) {
 				std::cerr << "ERROR: " << err << '\n';
 			}
+			if (show_statistics) {
+				std::cout << "instructions:\n";
+				for (auto& [command, count] : results.instructions) {
+					std::cout << "\t" << command << " " << count << "\n";
+				}
+			}
 
 			if (results.errors.size() > 0 && playMode) {
 				std::cerr << "Cancelling play mode. Errors detected in compilation" << std::endl;
@@ -200,6 +234,9 @@ int main(int argc, const char** argv)
 		// Start runner
 		runner  thread;
 		globals variables;
+
+		// snapshot at the last choice, for the delta size in the statistics
+		std::unique_ptr<snapshot> last_snapshot;
 		if (snapshotFile.size()) {
 			auto snap_ptr = snapshot::from_file(snapshotFile.c_str());
 			thread        = myInk->new_runner_from_snapshot(*snap_ptr);
@@ -240,8 +277,18 @@ int main(int argc, const char** argv)
 				}
 
 				if (show_statistics) {
-					std::cout << "runner:" << thread->statistics() << "globals:" << variables->statistics()
-					          << std::endl;
+					std::cout << "story:" << myInk->statistics() << "runner:" << thread->statistics()
+					          << "globals:" << variables->statistics() << std::endl;
+
+					// size of an autosave at this choice, full and as delta to the one at the last choice
+					std::unique_ptr<snapshot> snap{thread->create_snapshot()};
+					std::cout << "snapshot: " << snap->get_data_len() << " bytes";
+					if (last_snapshot) {
+						std::unique_ptr<snapshot> delta{thread->create_delta_snapshot(*last_snapshot)};
+						std::cout << ", delta: " << delta->get_data_len() << " bytes";
+					}
+					std::cout << std::endl;
+					last_snapshot = std::move(snap);
 				}
 
 				int c = 0;
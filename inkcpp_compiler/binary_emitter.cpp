@@ -13,6 +13,7 @@
 #include <vector>
 #include <map>
 #include <fstream>
+#include <sstream>
 #include <algorithm>
 
 #ifndef _MSC_VER
@@ -280,30 +281,41 @@ void binary_emitter::output(std::ostream& out)
 	header._container_hash.setup(offset, container_hash.size() * sizeof(container_hash_t));
 	header._instructions.setup(offset, _instructions.pos());
 
-	// Write the header
-	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
-	close_section(out);
+	// Write the sections first, the header contains their hash. The first section starts aligned,
+	// so the alignment in the buffer matches the alignment in the file.
+	std::stringstream sections;
 
 	// Write the string table
-	emit_section(out, _strings);
+	emit_section(sections, _strings);
 
 	// Write lists meta data and defined lists
-	emit_section(out, _list_meta);
+	emit_section(sections, _list_meta);
 
 	// Write lists meta data and defined lists
-	emit_section(out, _lists);
+	emit_section(sections, _lists);
 
 	// Write out container information
-	emit_section(out, container_data);
+	emit_section(sections, container_data);
 
 	// Write out container map
-	emit_section(out, _container_map);
+	emit_section(sections, _container_map);
 
 	// Write container hash list
-	emit_section(out, container_hash);
+	emit_section(sections, container_hash);
 
 	// Write the container contents (instruction stream)
-	emit_section(out, _instructions);
+	emit_section(sections, _instructions);
+
+	// hash up to the end of the instructions, without the padding behind them
+	const std::string    data  = sections.str();
+	const unsigned char* begin = reinterpret_cast<const unsigned char*>(data.data());
+	const uint32_t       end   = header._instructions._start + header._instructions._bytes;
+	header._hash               = hash_data(begin, end - header._strings._start);
+
+	// Write the header
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	close_section(out);
+	out.write(data.data(), data.size());
 
 	// Flush the file
 	out.flush();
@@ -317,6 +329,7 @@ void binary_emitter::initialize()
 	_list_meta.reset();
 	_lists.reset();
 	_instructions.reset();
+	_fused = 0;
 
 	// clear other data
 	_paths.clear();
@@ -332,6 +345,13 @@ void binary_emitter::finalize()
 {
 	// post process path commands
 	process_paths();
+
+	mark_line_ends();
+
+	if constexpr (config::fuseInstructions) {
+		fuse_instructions();
+	}
+	count_instructions();
 }
 
 void binary_emitter::setContainerIndex(container_t index) { _current->counter_index = index; }
@@ -438,6 +458,156 @@ void binary_emitter::process_paths()
 	}
 }
 
+void binary_emitter::mark_line_ends()
+{
+	// counted containers inside another counted container. Leaving them keeps the container stack
+	// of the runner non-empty, so it does not end the story or return from a function.
+	std::vector<bool>                                   nested;
+	std::vector<std::pair<const container_data*, bool>> todo = {{_root, false}};
+	while (! todo.empty()) {
+		const container_data* container = todo.back().first;
+		bool                  counted   = todo.back().second;
+		todo.pop_back();
+		if (container->counter_index != ~0U) {
+			if (nested.size() <= container->counter_index) {
+				nested.resize(container->counter_index + 1);
+			}
+			nested[container->counter_index] = counted;
+			counted                          = true;
+		}
+		for (const container_data* child : container->children) {
+			todo.emplace_back(child, counted);
+		}
+	}
+
+	constexpr size_t size = CommandSize<uint32_t>;
+	const size_t     end  = _instructions.pos();
+	for (size_t offset = 0; offset < end; offset += size) {
+		if (static_cast<Command>(_instructions.get(offset)) == Command::NEWLINE
+		    && reaches_text(offset + size, nested)) {
+			CommandFlag flag = static_cast<CommandFlag>(_instructions.get(offset + 1));
+			flag |= CommandFlag::NEWLINE_ENDS_LINE;
+			_instructions.set(offset + 1, flag);
+		}
+	}
+}
+
+bool binary_emitter::reaches_text(size_t offset, const std::vector<bool>& nested) const
+{
+	// Only follow instructions whose effect is undone when the runner restores after looking past
+	// a newline. Everything else (glue, tags, choices, evaluations, calls, ends) may change the
+	// line or stop the story, and needs the lookahead. Loops without text stop after a few steps.
+	constexpr size_t size = CommandSize<uint32_t>;
+	const size_t     end  = _instructions.pos();
+	for (int step = 0; step < 32 && offset < end; ++step) {
+		const Command     cmd  = static_cast<Command>(_instructions.get(offset));
+		const CommandFlag flag = static_cast<CommandFlag>(_instructions.get(offset + 1));
+		byte_t            bytes[sizeof(uint32_t)];
+		for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+			bytes[i] = _instructions.get(offset + sizeof(Command) + sizeof(CommandFlag) + i);
+		}
+		uint32_t value;
+		memcpy(&value, bytes, sizeof(uint32_t));
+
+		switch (cmd) {
+			case Command::STR: {
+				std::string text;
+				for (char c; (c = static_cast<char>(_strings.get(value))) != 0; ++value) {
+					text += c;
+				}
+				if (! ink::internal::is_whitespace(text.c_str(), false)) {
+					return true;
+				}
+			} break;
+			case Command::START_CONTAINER_MARKER: break;
+			case Command::END_CONTAINER_MARKER:
+				if (value >= nested.size() || ! nested[value]) {
+					return false;
+				}
+				break;
+			case Command::DIVERT:
+				if (flag & CommandFlag::DIVERT_HAS_CONDITION) {
+					return false;
+				}
+				offset = value;
+				continue;
+			default: return false;
+		}
+		offset += size;
+	}
+	return false;
+}
+
+void binary_emitter::fuse_instructions()
+{
+	// Only the first command of a sequence is replaced. Everything else, including the operands,
+	// stays where it is, so jump targets, container offsets and nop offsets remain valid.
+	constexpr size_t size    = CommandSize<uint32_t>;
+	const size_t     end     = _instructions.pos();
+	auto             command = [this, end](size_t offset) {
+		return offset < end ? static_cast<Command>(_instructions.get(offset)) : Command::NUM_COMMANDS;
+	};
+
+	for (size_t offset = 0; offset < end;) {
+		Command next[4];
+		for (size_t i = 0; i < 4; ++i) {
+			next[i] = command(offset + (i + 1) * size);
+		}
+
+		Command fused = Command::NUM_COMMANDS;
+		switch (command(offset)) {
+			case Command::START_EVAL:
+				if (next[0] == Command::PUSH_VARIABLE_VALUE && next[1] == Command::INT
+				    && next[2] >= Command::BINARY_OPERATORS_START
+				    && next[2] <= Command::BINARY_OPERATORS_END && next[3] == Command::END_EVAL) {
+					fused = Command::EVAL_VARIABLE_OP_INT;
+				} else if (next[0] == Command::STR && next[1] == Command::END_EVAL) {
+					fused = Command::EVAL_STR;
+				}
+				break;
+			case Command::START_TAG:
+				if (next[0] == Command::STR && next[1] == Command::END_TAG) {
+					fused = Command::TAG_STR;
+				}
+				break;
+			case Command::STR:
+				if (next[0] == Command::NEWLINE) {
+					fused = Command::STR_NEWLINE;
+				}
+				break;
+			default: break;
+		}
+
+		if (fused == Command::NUM_COMMANDS) {
+			offset += size;
+			continue;
+		}
+		_instructions.set(offset, fused);
+		offset += fused_length(fused) * size;
+		++_fused;
+	}
+}
+
+void binary_emitter::count_instructions() const
+{
+	compilation_results* res = results();
+	if (res == nullptr) {
+		return;
+	}
+
+	res->instructions.clear();
+	const size_t end = _instructions.pos();
+	for (size_t offset = 0; offset < end;) {
+		Command     cmd  = static_cast<Command>(_instructions.get(offset));
+		std::string name = CommandStrings[static_cast<size_t>(cmd)];
+		if (name == "\n") {
+			name = "\\n";
+		}
+		++res->instructions[name];
+		offset += fused_length(cmd) * CommandSize<uint32_t>;
+	}
+}
+
 void binary_emitter::build_container_data(
     std::vector<container_data_t>& data, container_t parent, const container_data* context
 ) const
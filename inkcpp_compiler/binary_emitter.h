@@ -54,6 +54,18 @@ protected:
 private:
 	void process_paths();
 
+	// flag newlines which end their line for sure, see CommandFlag::NEWLINE_ENDS_LINE
+	void mark_line_ends();
+
+	// if executing from offset reaches text without anything which could change the line before
+	bool reaches_text(size_t offset, const std::vector<bool>& nested) const;
+
+	// replace common instruction sequences with a fused command (see Command::FUSED_BEGIN)
+	void fuse_instructions();
+
+	// report the number of instructions per command to the compilation results
+	void count_instructions() const;
+
 	template<typename type>
 	void emit_section(std::ostream& out, const std::vector<type>& data) const;
 	void emit_section(std::ostream& out, const binary_stream& stream) const;
@@ -82,6 +94,7 @@ private:
 	binary_stream _list_meta;
 	binary_stream _lists;
 	binary_stream _instructions;
+	size_t        _fused = 0; // number of fused instruction sequences
 
 	// positon to write address
 	// path as string
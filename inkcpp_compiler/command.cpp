@@ -96,7 +96,12 @@ const char* CommandStrings[]
        "START_CONTAINER",
        "END_CONTAINER",
 
-       "CALL_EXTERNAL"};
+       "CALL_EXTERNAL",
+
+       "inkcpp_EVAL_STR",
+       "inkcpp_EVAL_VARIABLE_OP_INT",
+       "inkcpp_TAG_STR",
+       "inkcpp_STR_NEWLINE"};
 
 template<unsigned A, unsigned B>
 struct equal {
@@ -8,6 +8,7 @@
 
 #include <vector>
 #include <string>
+#include <map>
 
 namespace ink::compiler
 {
@@ -18,5 +19,10 @@ typedef std::vector<std::string> error_list;
 struct compilation_results {
 	error_list warnings; ///< list of all warnings generated
 	error_list errors;   ///< list of all errors generated
+
+	/** number of instructions in the compiled story per command.
+	 * A fused instruction counts once for the whole sequence it replaces.
+	 */
+	std::map<std::string, size_t> instructions;
 };
 } // namespace ink::compiler
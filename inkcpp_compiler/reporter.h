@@ -41,6 +41,9 @@ protected:
 	// clears the results pointer
 	void clear_results();
 
+	// results pointer, nullptr if none was set
+	compilation_results* results() const { return _results; }
+
 	// report warning
 	std::ostream& warn();
 
@@ -108,3 +108,52 @@ SCENARIO("a restorable array can save/restore/forget", "[array]")
 		}
 	}
 }
+
+SCENARIO("a restorable array only undoes the changes since the save", "[array]")
+{
+	GIVEN("a saved array")
+	{
+		test_array array = test_array(40, 0U, ~0U);
+		array.set(1, 1);
+		array.set(35, 35);
+		array.save();
+
+		WHEN("an index is changed several times")
+		{
+			array.set(35, 100);
+			array.set(35, 101);
+			array.set(2, 102);
+
+			THEN("the saved value is still known")
+			{
+				REQUIRE(array[35] == 101);
+				REQUIRE(array.get_old(35) == 35);
+				REQUIRE(array.get_old(2) == 0);
+				REQUIRE(array.get_old(1) == 1);
+			}
+
+			THEN("restore returns to the saved values")
+			{
+				array.restore();
+				REQUIRE(array[35] == 35);
+				REQUIRE(array[2] == 0);
+				REQUIRE(array[1] == 1);
+			}
+		}
+
+		WHEN("the array grows while saved")
+		{
+			array.set(3, 103);
+			array.resize(80);
+			array.set(70, 170);
+
+			THEN("restore also undoes the changes made before growing")
+			{
+				array.restore();
+				REQUIRE(array[3] == 0);
+				REQUIRE(array[70] == 0);
+				REQUIRE(array[35] == 35);
+			}
+		}
+	}
+}
@@ -0,0 +1,147 @@
+#include "catch.hpp"
+
+#include <choice.h>
+#include <globals.h>
+#include <runner.h>
+#include <snapshot.h>
+#include <story.h>
+
+#include <string>
+#include <vector>
+
+using namespace ink::runtime;
+
+using async_call = runner_interface::async_call;
+
+// external functions which answer later, like requests to a server
+struct pending_requests {
+	std::vector<async_call> tokens;
+	std::vector<int>        ids;
+	int                     logs = 0;
+
+	void bind(runner& thread)
+	{
+		thread->bind_async("fetch_name", [this](async_call token, int id) {
+			tokens.push_back(token);
+			ids.push_back(id);
+		});
+		thread->bind_async("log", [this](async_call token, const char*) {
+			tokens.push_back(token);
+			ids.push_back(0);
+			++logs;
+		});
+	}
+
+	// answers the oldest request
+	void answer(runner& thread)
+	{
+		static const char* names[] = {nullptr, "Anna", "Bob", "Carl"};
+		REQUIRE(! tokens.empty());
+		if (ids.front() == 0) {
+			thread->resume_external(tokens.front());
+		} else {
+			thread->resume_external(tokens.front(), value(names[ids.front()]));
+		}
+		tokens.erase(tokens.begin());
+		ids.erase(ids.begin());
+	}
+};
+
+SCENARIO("a story with asynchronous external functions", "[story][external]")
+{
+	GIVEN("a story calling functions which answer later")
+	{
+		std::unique_ptr<story> ink{story::from_file(INK_TEST_RESOURCE_DIR "AsyncExternalFunction.bin")};
+		runner                 thread = ink->new_runner();
+		pending_requests       requests;
+		requests.bind(thread);
+
+		WHEN("a line calls a function")
+		{
+			std::string line = thread->getline();
+
+			THEN("the runner suspends until the result is delivered")
+			{
+				REQUIRE(line == "");
+				REQUIRE(thread->is_suspended());
+				REQUIRE_FALSE(thread->can_continue());
+				REQUIRE(requests.ids == std::vector<int>{1});
+
+				requests.answer(thread);
+				REQUIRE_FALSE(thread->is_suspended());
+				REQUIRE(thread->can_continue());
+				REQUIRE(thread->getline() == "Hello Anna!\n");
+			}
+		}
+
+		WHEN("the story is played while answering the requests")
+		{
+			std::vector<std::string> lines;
+			size_t                   suspensions = 0;
+			for (size_t step = 0; step < 20; ++step) {
+				if (thread->can_continue()) {
+					std::string line = thread->getline();
+					if (! line.empty()) {
+						lines.push_back(line);
+					}
+				} else if (thread->is_suspended()) {
+					++suspensions;
+					requests.answer(thread);
+				} else if (thread->has_choices()) {
+					REQUIRE(thread->num_choices() == 1);
+					REQUIRE(std::string(thread->get_choice(0)->text()) == "Ask Bob");
+					thread->choose(0);
+				} else {
+					break;
+				}
+			}
+
+			THEN("the output is complete and the functions are not called during lookahead")
+			{
+				REQUIRE(lines == std::vector<std::string>{"Hello Anna!\n", "Carl answers.\n"});
+				REQUIRE(suspensions == 4);
+				REQUIRE(requests.logs == 1);
+				REQUIRE(requests.tokens.empty());
+			}
+		}
+
+		WHEN("the function answers right away")
+		{
+			runner direct = ink->new_runner();
+			direct->bind_async("fetch_name", [&direct](async_call token, int) {
+				direct->resume_external(token, value("Dora"));
+			});
+			direct->bind_async("log", [&direct](async_call token, const char*) {
+				direct->resume_external(token);
+			});
+
+			THEN("the runner does not suspend")
+			{
+				REQUIRE(direct->getline() == "Hello Dora!\n");
+				REQUIRE(direct->getline() == "");
+				REQUIRE_FALSE(direct->is_suspended());
+				REQUIRE(std::string(direct->get_choice(0)->text()) == "Ask Dora");
+			}
+		}
+
+		WHEN("a snapshot is taken while suspended")
+		{
+			thread->getline();
+			REQUIRE(thread->is_suspended());
+			std::unique_ptr<snapshot> snap{thread->create_snapshot()};
+			runner                    loaded = ink->new_runner_from_snapshot(*snap);
+			pending_requests          loaded_requests;
+			loaded_requests.bind(loaded);
+			loaded_requests.tokens = requests.tokens;
+			loaded_requests.ids    = requests.ids;
+
+			THEN("the loaded runner waits for the same call")
+			{
+				REQUIRE(loaded->is_suspended());
+				REQUIRE_FALSE(loaded->can_continue());
+				loaded_requests.answer(loaded);
+				REQUIRE(loaded->getline() == "Hello Anna!\n");
+			}
+		}
+	}
+}
@@ -0,0 +1,83 @@
+#include "catch.hpp"
+
+#include <batch.h>
+#include <story.h>
+#include <globals.h>
+#include <runner.h>
+#include <choice.h>
+#include <compiler.h>
+
+#include <vector>
+
+using namespace ink::runtime;
+
+// steps the reference runner like the batch did and compares the output
+static void compare_result(runner& thread, size_t lines, const batch_result& result)
+{
+	for (size_t line = 0; thread->can_continue() && (lines == 0 || line < lines); ++line) {
+		REQUIRE(line < result.num_lines());
+		REQUIRE(result.line(line) == thread->getline());
+		REQUIRE(result.num_tags(line) == thread->num_tags());
+		for (size_t i = 0; i < thread->num_tags(); ++i) {
+			REQUIRE(result.tag(line, i) == thread->get_tag(i));
+		}
+	}
+	REQUIRE(result.num_choices() == thread->num_choices());
+	for (size_t i = 0; i < thread->num_choices(); ++i) {
+		REQUIRE(result.choice(i) == thread->get_choice(i)->text());
+	}
+	REQUIRE(result.can_continue() == thread->can_continue());
+}
+
+SCENARIO("a batch steps many runners in parallel", "[batch]")
+{
+	GIVEN("runners of a story in a batch")
+	{
+		const std::string filename = INK_TEST_RESOURCE_DIR "TagsStory.bin";
+		std::unique_ptr<story> ink{story::from_file(filename.c_str())};
+		batch_executor         batch(4);
+		std::vector<runner>    reference;
+		for (size_t i = 0; i < 32; ++i) {
+			batch.add(ink->new_runner());
+			reference.push_back(ink->new_runner());
+			// some runners read line by line
+			batch.continue_lines(i, i % 3);
+		}
+
+		WHEN("the batch is run until all runners are done")
+		{
+			THEN("every runner has the output of a runner stepped on its own")
+			{
+				for (size_t tick = 0; tick < 50; ++tick) {
+					batch.run();
+					bool done = true;
+					for (size_t i = 0; i < batch.size(); ++i) {
+						INFO("tick " << tick << " slot " << i);
+						const batch_result& result = batch.result(i);
+						compare_result(reference[i], i % 3, result);
+						if (! result.can_continue() && result.num_choices() > 0) {
+							size_t choice = (tick + i) % result.num_choices();
+							batch.choose(i, choice);
+							reference[i]->choose(choice);
+						}
+						done = done && ! result.can_continue() && result.num_choices() == 0;
+					}
+					if (done) {
+						break;
+					}
+				}
+			}
+		}
+
+		WHEN("runners share globals")
+		{
+			globals store = ink->new_globals();
+			batch.add(ink->new_runner(store));
+
+			THEN("they can not be added")
+			{
+				REQUIRE_THROWS_AS(batch.add(ink->new_runner(store)), ink::ink_exception);
+			}
+		}
+	}
+}
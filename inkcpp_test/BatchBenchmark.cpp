@@ -0,0 +1,64 @@
+// Scaling benchmark of batch_executor. Steps many independent sessions of one story with 1 up to
+// the number of hardware threads (or the given maximum) and prints the time and speedup for each
+// thread count.
+//
+// usage: inkcpp_batch_benchmark [<story.bin> [<sessions> [<ticks> [<max threads>]]]]
+
+#include <batch.h>
+#include <story.h>
+#include <globals.h>
+#include <runner.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace ink::runtime;
+
+int main(int argc, const char** argv)
+{
+	using clock             = std::chrono::steady_clock;
+	const char* filename    = argc > 1 ? argv[1] : INK_TEST_RESOURCE_DIR "TheIntercept.bin";
+	size_t      sessions    = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+	size_t      ticks       = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 20;
+	size_t      max_threads = argc > 4 ? std::strtoul(argv[4], nullptr, 10)
+	                                   : std::max(1u, std::thread::hardware_concurrency());
+
+	std::unique_ptr<story> ink{story::from_file(filename)};
+	std::cout << filename << ": " << sessions << " sessions, " << ticks << " ticks, "
+	          << "up to " << max_threads << " threads\n"
+	          << "threads\tms\tlines\tspeedup\n";
+
+	double single = 0;
+	for (size_t threads = 1; threads <= max_threads;
+	     threads        = threads < max_threads ? std::min(threads * 2, max_threads) : threads + 1) {
+		// every session has its own globals
+		batch_executor batch(threads);
+		for (size_t i = 0; i < sessions; ++i) {
+			batch.add(ink->new_runner());
+			batch.get(i)->set_rng_seed(static_cast<uint32_t>(i));
+		}
+		size_t lines = 0;
+		auto   start = clock::now();
+		for (size_t tick = 0; tick < ticks; ++tick) {
+			batch.run();
+			for (size_t i = 0; i < batch.size(); ++i) {
+				const batch_result& result = batch.result(i);
+				lines += result.num_lines();
+				if (result.num_choices() > 0) {
+					batch.choose(i, (tick + i) % result.num_choices());
+				}
+			}
+		}
+		std::chrono::duration<double, std::milli> ms = clock::now() - start;
+		if (threads == 1) {
+			single = ms.count();
+		}
+		std::cout << threads << "\t" << ms.count() << "\t" << lines << "\t" << single / ms.count()
+		          << "\n";
+	}
+	return EXIT_SUCCESS;
+}
@@ -388,3 +388,61 @@ SCENARIO("threading with the callstack", "[callstack]")
 		}
 	}
 }
+
+SCENARIO("temporary variable lookups across frames", "[callstack]")
+{
+	GIVEN("a callstack with temporary variables which have been looked up")
+	{
+		auto stack = ink::runtime::internal::stack<50>();
+		bool eval  = false;
+
+		stack.set(X, 100_v);
+		stack.set(Y, 200_v);
+		REQUIRE(stack.get(X)->get<value_type::int32>() == 100);
+		REQUIRE(stack.get(Y)->get<value_type::int32>() == 200);
+
+		WHEN("a function frame is pushed")
+		{
+			stack.push_frame<frame_type::function>(0, false);
+
+			THEN("the callers variables are not visible") { REQUIRE(stack.get(X) == nullptr); }
+
+			WHEN("the function defines a variable with the same name and returns")
+			{
+				stack.set(X, 300_v);
+				REQUIRE(stack.get(X)->get<value_type::int32>() == 300);
+				stack.pop_frame(nullptr, eval);
+
+				THEN("the callers value is found again")
+				{
+					REQUIRE(stack.get(X)->get<value_type::int32>() == 100);
+					REQUIRE(stack.get(Y)->get<value_type::int32>() == 200);
+				}
+			}
+		}
+
+		WHEN("the variables are changed while saved")
+		{
+			stack.save();
+			stack.set(X, 101_v);
+			REQUIRE(stack.get(X)->get<value_type::int32>() == 101);
+
+			THEN("restoring finds the old value") {
+				stack.restore();
+				REQUIRE(stack.get(X)->get<value_type::int32>() == 100);
+			}
+
+			THEN("forgetting keeps the new value") {
+				stack.forget();
+				REQUIRE(stack.get(X)->get<value_type::int32>() == 101);
+			}
+		}
+
+		WHEN("the stack is cleared")
+		{
+			stack.clear();
+
+			THEN("nothing is found") { REQUIRE(stack.get(X) == nullptr); }
+		}
+	}
+}
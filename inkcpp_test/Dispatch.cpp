@@ -0,0 +1,129 @@
+#include "catch.hpp"
+#include "../runner_impl.h"
+
+#include <chrono>
+#include <compiler.h>
+#include <globals.h>
+#include <runner.h>
+#include <story.h>
+
+using namespace ink::runtime;
+
+static constexpr const char* THREADED_ENGINE =
+#if defined(INK_ENABLE_COMPUTED_GOTO)
+    "threaded (computed goto)";
+#else
+    "threaded (switch)";
+#endif
+
+SCENARIO("run a story with the traced dispatch loop", "[dispatch]")
+{
+	GIVEN("a story with a long running loop")
+	{
+		std::unique_ptr<story> ink{story::from_file(INK_TEST_RESOURCE_DIR "DispatchStory.bin")};
+		auto                   thread = ink->new_runner().cast<internal::runner_impl>();
+		auto                   traced = ink->new_runner().cast<internal::runner_impl>();
+		std::stringstream      debug;
+		traced->set_debug_enabled(&debug);
+
+		WHEN("run with and without debug stream")
+		{
+			std::string output = thread->getall();
+			THEN("both produce the same output")
+			{
+				REQUIRE(output == traced->getall());
+				REQUIRE(output.rfind("1000: 1000000\nTotal 2002 fizz 333\n") != std::string::npos);
+				REQUIRE(debug.str().size() > 0);
+			}
+		}
+	}
+}
+
+SCENARIO("story decodes its instructions on load", "[dispatch]")
+{
+	std::unique_ptr<story> ink{story::from_file(INK_TEST_RESOURCE_DIR "DispatchStory.bin")};
+	ink::config::statistics::story stats = ink->statistics();
+	REQUIRE(stats.instructions > 0);
+	if constexpr (ink::config::predecodeInstructions) {
+		REQUIRE(stats.decoded_instructions >= stats.instructions * 6);
+	} else {
+		REQUIRE(stats.decoded_instructions == 0);
+	}
+}
+
+// instructions per second of a dispatch engine, running the story from the beginning
+static double
+    dispatch_rate(story& ink, size_t instructions, int runs, [[maybe_unused]] bool threaded)
+{
+	size_t chars = 0;
+	auto   start = std::chrono::steady_clock::now();
+	for (int i = 0; i < runs; ++i) {
+		auto thread = ink.new_runner().cast<internal::runner_impl>();
+#ifdef INK_ENABLE_THREADED_DISPATCH
+		thread->set_threaded_dispatch(threaded);
+#endif
+		chars += thread->getall().size();
+	}
+	std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+	REQUIRE(chars > 0);
+	return static_cast<double>(instructions) * runs / seconds.count();
+}
+
+SCENARIO("instruction dispatch throughput", "[.benchmark][dispatch]")
+{
+	std::unique_ptr<story> ink{story::from_file(INK_TEST_RESOURCE_DIR "DispatchStory.bin")};
+
+	// count executed instructions with the traced loop, it writes one line per instruction
+	size_t instructions = 0;
+	{
+		auto              thread = ink->new_runner().cast<internal::runner_impl>();
+		std::stringstream debug;
+		thread->set_debug_enabled(&debug);
+		thread->getall();
+		for (char c : debug.str()) {
+			instructions += c == '\n';
+		}
+	}
+
+	constexpr int runs     = 200;
+	double        switched = dispatch_rate(*ink, instructions, runs, false);
+	WARN(
+	    "switch: " << instructions << " instructions x " << runs << " runs = " << switched
+	               << " instructions/s"
+	);
+#ifdef INK_ENABLE_THREADED_DISPATCH
+	double threaded = dispatch_rate(*ink, instructions, runs, true);
+	WARN(
+	    THREADED_ENGINE << ": " << instructions << " instructions x " << runs << " runs = "
+	                    << threaded << " instructions/s, speedup " << threaded / switched
+	);
+#endif
+}
+
+SCENARIO("compiler fuses common instruction sequences", "[dispatch]")
+{
+	GIVEN("a compiled story")
+	{
+		ink::compiler::compilation_results results;
+		ink::compiler::run(INK_TEST_RESOURCE_DIR "simple-1.1.1-inklecate.json", "fused.bin", &results);
+		std::unique_ptr<story> ink{story::from_file("fused.bin")};
+		runner                 thread = ink->new_runner();
+
+		THEN("text followed by a newline is fused")
+		{
+			REQUIRE(results.instructions["\\n"] > 0);
+			if constexpr (ink::config::fuseInstructions) {
+				REQUIRE(results.instructions["inkcpp_STR_NEWLINE"] > 0);
+			} else {
+				REQUIRE(results.instructions.count("inkcpp_STR_NEWLINE") == 0);
+			}
+		}
+		THEN("the story produces the same output")
+		{
+			REQUIRE(thread->getall() == "Once upon a time...\n");
+			REQUIRE(thread->num_choices() == 2);
+			thread->choose(0);
+			REQUIRE(thread->getall() == "There were two choices.\nThey lived happily ever after.\n");
+		}
+	}
+}
@@ -35,3 +35,55 @@ SCENARIO("a story with an external function evaluates the function at the right
 		}
 	}
 }
+
+SCENARIO("external functions bound to the story are shared by its runners", "[story]")
+{
+	GIVEN("a story with a function bound to it")
+	{
+		std::unique_ptr<story> ink{story::from_file(INK_TEST_RESOURCE_DIR
+		                                            "ExternalFunctionsExecuteProperly.bin")};
+		runner                 before = ink->new_runner();
+
+		int calls = 0;
+		ink->bind("GET_LINE_COUNT", [&calls]() { return ++calls * 10; });
+		runner after = ink->new_runner();
+
+		WHEN("runners created before and after the binding are run")
+		{
+			std::string first  = before->getline();
+			std::string second = after->getline();
+
+			THEN("both call the shared function")
+			{
+				REQUIRE(first == "Line count: 10\n");
+				REQUIRE(second == "Line count: 20\n");
+				REQUIRE(before->getline() == "Line count: 30\n");
+				REQUIRE(calls == 3);
+			}
+		}
+
+		WHEN("a runner binds a function with the same name")
+		{
+			after->getline();
+			after->bind("GET_LINE_COUNT", []() { return -1; });
+
+			THEN("the runner calls its own function, the others the shared one")
+			{
+				REQUIRE(after->getline() == "Line count: -1\n");
+				REQUIRE(before->getline() == "Line count: 20\n");
+				REQUIRE(calls == 2);
+			}
+		}
+
+		WHEN("a runner is cloned")
+		{
+			before->getline();
+			runner copy = before->clone();
+
+			THEN("the copy calls the shared function without binding it again")
+			{
+				REQUIRE(copy->getline() == "Line count: 20\n");
+			}
+		}
+	}
+}
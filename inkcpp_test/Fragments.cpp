@@ -0,0 +1,57 @@
+#include "catch.hpp"
+
+#include <chrono>
+#include <compiler.h>
+#include <globals.h>
+#include <runner.h>
+#include <story.h>
+
+using namespace ink::runtime;
+
+static std::string expected_fragments_line()
+{
+	std::string line;
+	for (int i = 0; i < 500; ++i) {
+		line += std::to_string(i) + ",";
+	}
+	return line + "done\n";
+}
+
+SCENARIO("a line glued together from many fragments", "[output]")
+{
+	GIVEN("a story which glues 500 fragments into one line")
+	{
+		std::unique_ptr<story> ink{story::from_file(INK_TEST_RESOURCE_DIR "FragmentsStory.bin")};
+		runner                 thread = ink->new_runner();
+
+		WHEN("run")
+		{
+			std::string line = thread->getline();
+			THEN("all fragments end up in one line")
+			{
+				REQUIRE(line == expected_fragments_line());
+				REQUIRE_FALSE(thread->can_continue());
+			}
+		}
+	}
+}
+
+SCENARIO("line with many fragments throughput", "[.benchmark][output]")
+{
+	std::unique_ptr<story> ink{story::from_file(INK_TEST_RESOURCE_DIR "FragmentsStory.bin")};
+
+	constexpr int runs  = 200;
+	size_t        chars = 0;
+	auto          start = std::chrono::steady_clock::now();
+	for (int i = 0; i < runs; ++i) {
+		runner thread = ink->new_runner();
+		chars += thread->getline().size();
+	}
+	std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+	WARN(
+	    "500 fragments x " << runs << " runs in " << seconds.count() << "s = "
+	                       << seconds.count() / runs * 1000 << "ms per line"
+	);
+	REQUIRE(chars == expected_fragments_line().size() * runs);
+}
@@ -5,6 +5,8 @@
 #include <runner.h>
 #include <compiler.h>
 
+#include <chrono>
+
 using namespace ink::runtime;
 
 SCENARIO("run story with global variable", "[global variables]")
@@ -69,3 +71,52 @@ SCENARIO("run story with global variable", "[global variables]")
 		}
 	}
 }
+
+SCENARIO("run story with many global variables", "[global variables]")
+{
+	GIVEN("a story with 300 global variables")
+	{
+		std::unique_ptr<story> ink{story::from_file(INK_TEST_RESOURCE_DIR "ManyGlobalsStory.bin")};
+		globals                globStore = ink->new_globals();
+		runner                 thread    = ink->new_runner(globStore);
+
+		WHEN("just runs")
+		{
+			THEN("variables are found in the index")
+			{
+				REQUIRE(thread->getall() == "3999 500799\n");
+				REQUIRE(*globStore->get<int32_t>("g0") == 3999);
+				REQUIRE(*globStore->get<int32_t>("g150") == 150);
+				REQUIRE(*globStore->get<int32_t>("g299") == 500799);
+				REQUIRE_FALSE(globStore->get<int32_t>("g300").has_value());
+			}
+		}
+		WHEN("edit variables before run")
+		{
+			REQUIRE(globStore->set<int32_t>("g0", 1));
+			REQUIRE(globStore->set<int32_t>("g299", 0));
+			THEN("story uses the new values")
+			{
+				REQUIRE(thread->getall() == "2003 500500\n");
+				REQUIRE(*globStore->get<int32_t>("g299") == 500500);
+			}
+		}
+	}
+}
+
+SCENARIO("global variable access throughput", "[.benchmark][global variables]")
+{
+	std::unique_ptr<story> ink{story::from_file(INK_TEST_RESOURCE_DIR "ManyGlobalsStory.bin")};
+
+	constexpr int runs  = 200;
+	size_t        chars = 0;
+	auto          start = std::chrono::steady_clock::now();
+	for (int i = 0; i < runs; ++i) {
+		runner thread = ink->new_runner();
+		chars += thread->getall().size();
+	}
+	std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+	WARN("300 globals x " << runs << " runs in " << seconds.count() << "s");
+	REQUIRE(chars > 0);
+}
@@ -0,0 +1,129 @@
+#include "catch.hpp"
+#include "../story_impl.h"
+
+#include <choice.h>
+#include <command.h>
+#include <globals.h>
+#include <runner.h>
+#include <story.h>
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace ink::runtime;
+
+// story file with all NEWLINE_ENDS_LINE flags removed, so the runner looks past every newline
+static std::vector<unsigned char> without_line_ends(const char* filename, size_t& flagged)
+{
+	std::ifstream              file(filename, std::ios::binary);
+	std::vector<unsigned char> data{
+	    std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()
+	};
+	internal::story_impl ink(data.data(), data.size(), false);
+	const size_t         begin = static_cast<size_t>(ink.instructions() - data.data());
+	const size_t         count = static_cast<size_t>(ink.statistics().instructions);
+	const unsigned char  mask  = static_cast<unsigned char>(ink::CommandFlag::NEWLINE_ENDS_LINE);
+	flagged                    = 0;
+	for (size_t i = 0; i < count; ++i) {
+		unsigned char* inst = &data[begin + i * ink::CommandSize<uint32_t>];
+		unsigned char& flag = inst[sizeof(ink::Command)];
+		if (static_cast<ink::Command>(inst[0]) == ink::Command::NEWLINE && (flag & mask) != 0) {
+			flag &= ~mask;
+			++flagged;
+		}
+	}
+	return data;
+}
+
+// plays both runners with the same choices and compares everything they report
+static void compare(runner flagged, runner plain)
+{
+	flagged->set_rng_seed(42);
+	plain->set_rng_seed(42);
+	for (size_t step = 0; step < 500; ++step) {
+		INFO("step " << step);
+		REQUIRE(flagged->can_continue() == plain->can_continue());
+		if (flagged->can_continue()) {
+			REQUIRE(flagged->getline() == plain->getline());
+			REQUIRE(flagged->num_tags() == plain->num_tags());
+			for (size_t i = 0; i < flagged->num_tags(); ++i) {
+				REQUIRE(std::string(flagged->get_tag(i)) == plain->get_tag(i));
+			}
+			continue;
+		}
+		REQUIRE(flagged->num_choices() == plain->num_choices());
+		if (! flagged->has_choices()) {
+			break;
+		}
+		for (size_t i = 0; i < flagged->num_choices(); ++i) {
+			REQUIRE(std::string(flagged->get_choice(i)->text()) == plain->get_choice(i)->text());
+		}
+		flagged->choose(step % flagged->num_choices());
+		plain->choose(step % plain->num_choices());
+	}
+}
+
+SCENARIO("newlines which end their line", "[runner]")
+{
+	for (const char* name : {"TheIntercept.bin", "TagsStory.bin", "LinesStory.bin", "GlobalStory.bin"}
+	) {
+		GIVEN(name)
+		{
+			const std::string          filename = std::string(INK_TEST_RESOURCE_DIR) + name;
+			size_t                     flagged  = 0;
+			std::vector<unsigned char> plain    = without_line_ends(filename.c_str(), flagged);
+
+			std::unique_ptr<story> with_flags{story::from_file(filename.c_str())};
+			std::unique_ptr<story> without_flags{story::from_binary(plain.data(), plain.size(), false)};
+
+			THEN("ending lines early gives the same output as looking past every newline")
+			{
+				compare(with_flags->new_runner(), without_flags->new_runner());
+			}
+		}
+	}
+
+	GIVEN("a story with consecutive lines")
+	{
+		size_t flagged = 0;
+		without_line_ends(INK_TEST_RESOURCE_DIR "TheIntercept.bin", flagged);
+		THEN("the compiler finds newlines which end their line") { REQUIRE(flagged > 0); }
+	}
+}
+
+SCENARIO("line cost with and without early line ends", "[.benchmark][runner]")
+{
+	using clock                        = std::chrono::steady_clock;
+	const char*                filename = INK_TEST_RESOURCE_DIR "TheIntercept.bin";
+	size_t                     flagged  = 0;
+	std::vector<unsigned char> plain    = without_line_ends(filename, flagged);
+
+	std::unique_ptr<story> with_flags{story::from_file(filename)};
+	std::unique_ptr<story> without_flags{story::from_binary(plain.data(), plain.size(), false)};
+	for (story* ink : {with_flags.get(), without_flags.get()}) {
+		size_t      lines = 0;
+		std::string line;
+		auto        start = clock::now();
+		for (uint32_t seed = 0; seed < 200; ++seed) {
+			runner thread = ink->new_runner();
+			thread->set_rng_seed(seed);
+			for (size_t step = 0; step < 500; ++step) {
+				if (thread->can_continue()) {
+					thread->getline(line);
+					++lines;
+				} else if (thread->has_choices()) {
+					thread->choose((seed + step) % thread->num_choices());
+				} else {
+					break;
+				}
+			}
+		}
+		std::chrono::duration<double, std::micro> us = clock::now() - start;
+		WARN(
+		    (ink == with_flags.get() ? "early line ends: " : "lookahead only: ") << us.count() / lines
+		                                                                          << " us/line"
+		);
+	}
+}
@@ -0,0 +1,78 @@
+#include "catch.hpp"
+
+#include <story.h>
+#include <globals.h>
+#include <runner.h>
+#include <snapshot.h>
+#include <compiler.h>
+
+#include <chrono>
+#include <sstream>
+
+using namespace ink::runtime;
+
+// story of count knots, each printing one line and diverting to the next. Each knot counts its
+// visits, so the globals track a visit count per knot.
+static void compile_chain(size_t count, const char* filename)
+{
+	std::stringstream json;
+	json << R"({"inkVersion":21,"root":[[{"->":"k0"},["done",{"#n":"g-0"}],null],"done",{)";
+	for (size_t i = 0; i < count; ++i) {
+		json << (i ? "," : "") << "\"k" << i << "\":[\"^Line " << i << "\",\"\\n\",";
+		if (i + 1 < count) {
+			json << "{\"->\":\"k" << i + 1 << "\"}";
+		} else {
+			json << "\"end\"";
+		}
+		json << ",{\"#f\":1}]";
+	}
+	json << R"(}],"listDefs":{}})";
+	ink::compiler::run(json, filename);
+}
+
+SCENARIO("a story with many containers", "[globals]")
+{
+	GIVEN("a chain of knots")
+	{
+		compile_chain(2000, "chain.bin");
+		std::unique_ptr<story> ink{story::from_file("chain.bin")};
+		globals                store  = ink->new_globals();
+		runner                 thread = ink->new_runner(store);
+
+		WHEN("it is played to the end")
+		{
+			size_t lines = 0;
+			while (thread->can_continue()) {
+				REQUIRE(thread->getline() == "Line " + std::to_string(lines) + "\n");
+				++lines;
+			}
+
+			THEN("every knot printed its line and the visit counts can be stored")
+			{
+				REQUIRE(lines == 2000);
+				std::unique_ptr<snapshot> snap{thread->create_snapshot()};
+				runner                    loaded = ink->new_runner_from_snapshot(*snap);
+				REQUIRE_FALSE(loaded->can_continue());
+			}
+		}
+	}
+}
+
+SCENARIO("line cost with many containers", "[.benchmark][globals]")
+{
+	using clock = std::chrono::steady_clock;
+	for (size_t count : {1000, 10000, 50000}) {
+		compile_chain(count, "chain.bin");
+		std::unique_ptr<story> ink{story::from_file("chain.bin")};
+		runner                 thread = ink->new_runner();
+		size_t                 lines  = 0;
+		std::string            line;
+		auto                   start = clock::now();
+		while (thread->can_continue()) {
+			thread->getline(line);
+			++lines;
+		}
+		std::chrono::duration<double, std::micro> us = clock::now() - start;
+		WARN(count << " containers: " << us.count() / lines << " us/line");
+	}
+}
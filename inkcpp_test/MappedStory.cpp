@@ -0,0 +1,94 @@
+#include "catch.hpp"
+
+#include <story.h>
+#include <globals.h>
+#include <runner.h>
+#include <compiler.h>
+
+#include <chrono>
+#include <fstream>
+#include <vector>
+
+using namespace ink::runtime;
+
+#ifdef INK_ENABLE_MMAP
+SCENARIO("a story can be loaded from a memory mapped file", "[story]")
+{
+	GIVEN("a compiled story")
+	{
+		ink::compiler::run(INK_TEST_RESOURCE_DIR "simple-1.1.1-inklecate.json", "mapped.bin");
+
+		WHEN("it is mapped")
+		{
+			std::unique_ptr<story> read{story::from_file("mapped.bin")};
+			std::unique_ptr<story> mapped{story::from_mmap("mapped.bin")};
+			runner                 read_thread   = read->new_runner();
+			runner                 mapped_thread = mapped->new_runner();
+
+			THEN("it runs like the loaded story")
+			{
+				REQUIRE(mapped->hash() == read->hash());
+				REQUIRE(mapped_thread->getall() == read_thread->getall());
+				mapped_thread->choose(1);
+				read_thread->choose(1);
+				REQUIRE(mapped_thread->getall() == read_thread->getall());
+			}
+		}
+
+		WHEN("the file is truncated")
+		{
+			{
+				std::ifstream     in("mapped.bin", std::ios::binary);
+				std::vector<char> data{std::istreambuf_iterator<char>(in), {}};
+				std::ofstream     out("truncated.bin", std::ios::binary);
+				out.write(data.data(), data.size() / 2);
+			}
+
+			THEN("mapping it fails")
+			{
+				REQUIRE_THROWS_AS(story::from_mmap("truncated.bin"), ink::ink_exception);
+			}
+		}
+	}
+}
+
+#	ifdef __linux__
+// resident memory of this process in kB, split into anonymous and file backed pages
+static void resident_memory(long& anon, long& file)
+{
+	std::ifstream status("/proc/self/status");
+	std::string   line;
+	while (std::getline(status, line)) {
+		if (line.rfind("RssAnon:", 0) == 0) {
+			anon = std::stol(line.substr(8));
+		} else if (line.rfind("RssFile:", 0) == 0) {
+			file = std::stol(line.substr(8));
+		}
+	}
+}
+
+SCENARIO("memory mapped loading cost", "[.benchmark][story]")
+{
+	constexpr int count    = 200;
+	const char*   filename = INK_TEST_RESOURCE_DIR "TheIntercept.bin";
+	auto          measure  = [&](const char* name, story* (*load)(const char*)) {
+		std::vector<std::unique_ptr<story>> stories;
+		long anon_before = 0, file_before = 0, anon = 0, file = 0;
+		resident_memory(anon_before, file_before);
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < count; ++i) {
+			stories.emplace_back(load(filename));
+		}
+		std::chrono::duration<double, std::micro> us = std::chrono::steady_clock::now() - start;
+		resident_memory(anon, file);
+		WARN(
+		    name << ": " << us.count() / count << " us/story, RssAnon +" << anon - anon_before
+		         << " kB, RssFile +" << file - file_before << " kB for " << count << " stories"
+		);
+	};
+
+	measure("from_file", [](const char* f) { return story::from_file(f); });
+	measure("from_mmap", [](const char* f) { return story::from_mmap(f); });
+}
+#	endif
+#endif
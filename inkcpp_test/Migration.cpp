@@ -1,7 +1,11 @@
 #include "catch.hpp"
 #include "../snapshot_impl.h"
+#include "header.h"
 
+#include <algorithm>
+#include <fstream>
 #include <memory>
+#include <vector>
 #include <story.h>
 #include <globals.h>
 #include <choice.h>
@@ -231,3 +235,101 @@ SCENARIO("Migration Test for small story", "[migration]")
 		REQUIRE(thread_after->getall() == "We got ice cream, mine was raspberry!\nWe're going to the seaside!\nSo far we've done the following: Swimming, SandCastle, IceCream\n");
 	}
 }
+
+SCENARIO("the story hash is stored in the story file", "[migration]")
+{
+	GIVEN("a compiled story")
+	{
+		ink::compiler::run(INK_TEST_RESOURCE_DIR "simple-1.1.1-inklecate.json", "hash.bin");
+		std::ifstream              in("hash.bin", std::ios::binary);
+		std::vector<unsigned char> data{std::istreambuf_iterator<char>(in), {}};
+		const auto& header = *reinterpret_cast<const ink::internal::header*>(data.data());
+		std::unique_ptr<story> ink{story::from_file("hash.bin")};
+
+		THEN("the header contains the hash of the sections")
+		{
+			const uint32_t end = header._instructions._start + header._instructions._bytes;
+			REQUIRE(header.has_hash());
+			REQUIRE(
+			    header._hash
+			    == ink::hash_data(data.data() + header._strings._start, end - header._strings._start)
+			);
+			REQUIRE(ink->hash() == header._hash);
+		}
+
+		THEN("older files keep their former hash")
+		{
+			std::vector<unsigned char> older = data;
+			reinterpret_cast<ink::internal::header*>(older.data())->ink_bin_version_number
+			    = ink::internal::header::FusedVersion;
+			std::unique_ptr<story> older_ink{story::from_binary(older.data(), older.size(), false)};
+			const uint32_t         end = header._instructions._start + header._instructions._bytes;
+			REQUIRE(older_ink->hash() == ink::hash_data_legacy(older.data(), end));
+			REQUIRE(older_ink->hash() != ink->hash());
+		}
+
+		WHEN("a snapshot is taken")
+		{
+			runner thread = ink->new_runner();
+			thread->getall();
+			std::unique_ptr<snapshot> snap{thread->create_snapshot()};
+
+			THEN("it belongs to the story")
+			{
+				REQUIRE(reinterpret_cast<internal::snapshot_impl*>(snap.get())->hash() == ink->hash());
+				runner loaded = ink->new_runner_from_snapshot(*snap);
+				REQUIRE(loaded->num_choices() == 2);
+			}
+		}
+	}
+}
+
+SCENARIO("delta snapshots only store the changes", "[migration]")
+{
+	GIVEN("a snapshot at the first choice of a story")
+	{
+		ink::compiler::run(INK_TEST_RESOURCE_DIR "simple-1.1.1-inklecate.json", "delta.bin");
+		std::unique_ptr<story> ink{story::from_file("delta.bin")};
+		runner                 thread = ink->new_runner();
+		thread->getall();
+		std::unique_ptr<snapshot> base{thread->create_snapshot()};
+		REQUIRE_FALSE(base->is_delta());
+		thread->choose(0);
+		REQUIRE(thread->getline() == "There were two choices.\n");
+
+		WHEN("a delta snapshot is taken after the choice")
+		{
+			std::unique_ptr<snapshot> delta{thread->create_delta_snapshot(*base)};
+			std::unique_ptr<snapshot> full{thread->create_snapshot()};
+
+			THEN("it reconstructs the full snapshot")
+			{
+				REQUIRE(delta->is_delta());
+				REQUIRE(delta->get_data_len() < full->get_data_len());
+				std::unique_ptr<snapshot> loaded{
+				    snapshot::from_delta(*base, delta->get_data(), delta->get_data_len())
+				};
+				REQUIRE(loaded->get_data_len() == full->get_data_len());
+				REQUIRE(
+				    std::equal(
+				        full->get_data(), full->get_data() + full->get_data_len(), loaded->get_data()
+				    )
+				);
+				runner again = ink->new_runner_from_snapshot(*loaded);
+				REQUIRE(again->getall() == "They lived happily ever after.\n");
+			}
+			THEN("the delta snapshot can be used directly")
+			{
+				runner again = ink->new_runner_from_snapshot(*delta);
+				REQUIRE(again->getall() == "They lived happily ever after.\n");
+			}
+			THEN("it can not be applied to another base")
+			{
+				REQUIRE_THROWS_AS(
+				    snapshot::from_delta(*full, delta->get_data(), delta->get_data_len()),
+				    ink::ink_exception
+				);
+			}
+		}
+	}
+}
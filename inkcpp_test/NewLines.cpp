@@ -3,6 +3,7 @@
 #include <story.h>
 #include <globals.h>
 #include <runner.h>
+#include <snapshot.h>
 #include <compiler.h>
 
 using namespace ink::runtime;
@@ -66,3 +67,65 @@ SCENARIO("a story has the proper line breaks", "[lines]")
 		}
 	}
 }
+
+SCENARIO("lines can be read into caller provided storage", "[lines]")
+{
+	GIVEN("a story")
+	{
+		ink::compiler::run(INK_TEST_RESOURCE_DIR "simple-1.1.1-inklecate.json", "getline.bin");
+		std::unique_ptr<story> ink{story::from_file("getline.bin")};
+		runner                 thread = ink->new_runner();
+
+		WHEN("the buffer is large enough")
+		{
+			char   buffer[64];
+			size_t length = thread->getline(buffer, sizeof(buffer));
+			THEN("the line is written and terminated")
+			{
+				REQUIRE(length == 20);
+				REQUIRE(std::string(buffer) == "Once upon a time...\n");
+				REQUIRE_FALSE(thread->can_continue());
+			}
+		}
+
+		WHEN("the buffer is too small")
+		{
+			size_t length = thread->getline(nullptr, 0);
+			THEN("the line is kept until it fits")
+			{
+				REQUIRE(length == 20);
+				REQUIRE(thread->can_continue());
+				char small[8];
+				REQUIRE(thread->getline(small, sizeof(small)) == 20);
+				REQUIRE(thread->can_continue());
+				char buffer[21];
+				REQUIRE(thread->getline(buffer, sizeof(buffer)) == 20);
+				REQUIRE(std::string(buffer) == "Once upon a time...\n");
+				REQUIRE(thread->num_choices() == 2);
+			}
+			THEN("the kept line survives a snapshot")
+			{
+				std::unique_ptr<snapshot> snap{thread->create_snapshot()};
+				runner                    loaded = ink->new_runner_from_snapshot(*snap);
+				REQUIRE(loaded->can_continue());
+				char buffer[21];
+				REQUIRE(loaded->getline(buffer, sizeof(buffer)) == 20);
+				REQUIRE(std::string(buffer) == "Once upon a time...\n");
+				REQUIRE(loaded->num_choices() == 2);
+			}
+		}
+
+		WHEN("reading into a reused string")
+		{
+			std::string line = "previous content";
+			thread->getline(line);
+			THEN("the string holds only the new line")
+			{
+				REQUIRE(line == "Once upon a time...\n");
+				thread->choose(0);
+				thread->getline(line);
+				REQUIRE(line == "There were two choices.\n");
+			}
+		}
+	}
+}
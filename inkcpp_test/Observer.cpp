@@ -8,6 +8,10 @@
 #include <runner.h>
 #include <story.h>
 
+#include <string>
+#include <utility>
+#include <vector>
+
 using namespace ink::runtime;
 
 SCENARIO("Observer", "[variables][observer]")
@@ -248,3 +252,63 @@ SCENARIO("Observer", "[variables][observer]")
 		}
 	}
 }
+
+SCENARIO("Deferred observers", "[variables][observer]")
+{
+	GIVEN("a story which writes variables several times per line and during lookahead")
+	{
+		using writes = std::vector<std::pair<int32_t, int32_t>>;
+		const char*            filename = INK_TEST_RESOURCE_DIR "DeferredObserverStory.bin";
+		std::unique_ptr<story> ink{story::from_file(filename)};
+		auto                   globals = ink->new_globals();
+		runner                 thread  = ink->new_runner(globals);
+
+		writes                   scores;
+		std::vector<std::string> names;
+		auto score = [&scores](int32_t i, ink::optional<int32_t> o_i) {
+			scores.emplace_back(i, o_i.has_value() ? o_i.value() : -1);
+		};
+		auto name = [&names](const char* s) { names.emplace_back(s); };
+		globals->observe("score", score);
+		globals->observe("name", name);
+		scores.clear();
+		names.clear();
+
+		WHEN("observers are called on every write")
+		{
+			std::string out = thread->getall();
+
+			THEN("they see every write, including the repeated write after the lookahead")
+			{
+				REQUIRE(out == "Line 2 b glued 3\nNext line 4\n");
+				REQUIRE(scores == writes{{1, 0}, {2, 1}, {3, 2}, {4, 3}, {4, 3}});
+				REQUIRE(names == std::vector<std::string>{"b"});
+			}
+		}
+
+		WHEN("observers are deferred")
+		{
+			globals->defer_observers(true);
+			std::string first       = thread->getline();
+			writes      after_first = scores;
+			std::string second      = thread->getline();
+
+			THEN("they are called once per line with the first old and last new value")
+			{
+				REQUIRE(first == "Line 2 b glued 3\n");
+				REQUIRE(second == "Next line 4\n");
+				REQUIRE(after_first == writes{{3, 0}});
+				REQUIRE(scores == writes{{3, 0}, {4, 3}});
+				REQUIRE(names == std::vector<std::string>{"b"});
+			}
+		}
+
+		WHEN("a write is set from outside while observers are deferred")
+		{
+			globals->defer_observers(true);
+			globals->set<int32_t>("score", 7);
+
+			THEN("the observers are called right away") { REQUIRE(scores.size() == 1); }
+		}
+	}
+}
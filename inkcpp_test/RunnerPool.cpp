@@ -0,0 +1,125 @@
+#include "catch.hpp"
+
+#include <story.h>
+#include <globals.h>
+#include <runner.h>
+#include <snapshot.h>
+#include <compiler.h>
+
+#include <chrono>
+
+using namespace ink::runtime;
+
+static constexpr const char* OUTPUT_START  = "Once upon a time...\n";
+static constexpr const char* OUTPUT_CHOICE = "There were two choices.\nThey lived happily ever after.\n";
+
+SCENARIO("runners are recycled by the story", "[runner]")
+{
+	GIVEN("a story")
+	{
+		ink::compiler::run(INK_TEST_RESOURCE_DIR "simple-1.1.1-inklecate.json", "pool.bin");
+		std::unique_ptr<story> ink{story::from_file("pool.bin")};
+		runner                 thread = ink->acquire_runner();
+		REQUIRE(thread->getall() == OUTPUT_START);
+
+		WHEN("a runner is released and acquired again")
+		{
+			runner_interface* released = thread.get();
+			ink->release_runner(thread);
+			REQUIRE_FALSE(thread);
+			runner again = ink->acquire_runner();
+
+			THEN("the same runner starts from the beginning")
+			{
+				REQUIRE(again.get() == released);
+				REQUIRE(again->getall() == OUTPUT_START);
+				REQUIRE(again->num_choices() == 2);
+				again->choose(0);
+				REQUIRE(again->getall() == OUTPUT_CHOICE);
+			}
+		}
+
+		WHEN("a runner is released while still in use")
+		{
+			runner            other    = thread;
+			runner_interface* released = thread.get();
+			ink->release_runner(thread);
+			runner again = ink->acquire_runner();
+
+			THEN("it is not recycled")
+			{
+				REQUIRE_FALSE(thread);
+				REQUIRE(other.get() == released);
+				REQUIRE(again.get() != released);
+				REQUIRE(other->num_choices() == 2);
+			}
+		}
+
+		WHEN("a runner is cloned")
+		{
+			runner copy = thread->clone();
+
+			THEN("the copy continues from the same position")
+			{
+				REQUIRE(copy->num_choices() == 2);
+				copy->choose(0);
+				REQUIRE(copy->getall() == OUTPUT_CHOICE);
+				REQUIRE(thread->num_choices() == 2);
+				thread->choose(0);
+				REQUIRE(thread->getall() == OUTPUT_CHOICE);
+			}
+		}
+	}
+}
+
+SCENARIO("cloning a runner", "[.benchmark][runner]")
+{
+	using clock         = std::chrono::steady_clock;
+	constexpr int runs  = 2000;
+	constexpr int turns = 10;
+
+	std::unique_ptr<story> ink{story::from_file(INK_TEST_RESOURCE_DIR "TheIntercept.bin")};
+	globals                store  = ink->new_globals();
+	runner                 thread = ink->new_runner(store);
+	for (int i = 0; i < turns && (thread->can_continue() || thread->num_choices() > 0); ++i) {
+		thread->getall();
+		if (thread->num_choices() > 0) {
+			thread->choose(i % thread->num_choices());
+		}
+	}
+	thread->getall();
+	std::unique_ptr<snapshot> snap{thread->create_snapshot()};
+
+	size_t choices = 0;
+	auto   start   = clock::now();
+	for (int i = 0; i < runs; ++i) {
+		runner fresh = ink->new_runner(store);
+		choices += fresh->num_choices();
+	}
+	std::chrono::duration<double, std::micro> construct = clock::now() - start;
+
+	// clone() copies the stacks, output, threads and choices of the runner directly
+	start = clock::now();
+	for (int i = 0; i < runs; ++i) {
+		runner copy = thread->clone();
+		choices += copy->num_choices();
+	}
+	std::chrono::duration<double, std::micro> clone = clock::now() - start;
+
+	start = clock::now();
+	for (int i = 0; i < runs; ++i) {
+		std::unique_ptr<snapshot> copy_snap{thread->create_snapshot()};
+		globals                   loaded_store = ink->new_globals_from_snapshot(*copy_snap);
+		runner                    loaded = ink->new_runner_from_snapshot(*copy_snap, loaded_store);
+		choices += loaded->num_choices();
+	}
+	std::chrono::duration<double, std::micro> round_trip = clock::now() - start;
+
+	WARN(
+	    "per runner: new_runner " << construct.count() / runs << " us, clone "
+	                              << clone.count() / runs << " us, snapshot round trip "
+	                              << round_trip.count() / runs << " us (" << snap->get_data_len()
+	                              << " byte snapshot)"
+	);
+	REQUIRE(choices == 2 * runs * thread->num_choices());
+}
@@ -0,0 +1,163 @@
+#include "catch.hpp"
+
+#include "../inkcpp/snapshot_impl.h"
+#include "../inkcpp/globals_impl.h"
+
+#include <story.h>
+#include <globals.h>
+#include <runner.h>
+#include <snapshot.h>
+#include <compiler.h>
+
+#include <chrono>
+#include <vector>
+
+using namespace ink::runtime;
+
+static constexpr const char* STORIES[] = {
+    "TheIntercept.bin",
+    "murder_scene.bin",
+    "LinesStory.bin",
+    "ListStory.bin",
+    "ListLogicStory.bin",
+    "TagsStory.bin",
+    "UTF8Story.bin",
+    "SimpleStoryFlow.bin",
+    "GlobalStory.bin",
+    "TempsStory.bin",
+    "FragmentsStory.bin",
+    "142_many_threads.bin",
+};
+
+// reads a line or takes a choice, and returns what happened
+static std::string advance(runner& thread, size_t step)
+{
+	if (thread->can_continue()) {
+		return thread->getline();
+	}
+	if (thread->has_choices()) {
+		size_t index = step % thread->num_choices();
+		thread->choose(index);
+		return "> " + std::to_string(index);
+	}
+	return "end";
+}
+
+// restores snapshots in both encodings, and in the formats of version 1 and 2 without the state of
+// asynchronous calls, at every few steps and checks that the copies continue exactly like the
+// original
+static void compare_restored(const std::string& filename)
+{
+	INFO(filename);
+	std::unique_ptr<story> ink{story::from_file(filename.c_str())};
+	std::unique_ptr<story> other{story::from_file(filename.c_str())};
+	globals                store  = ink->new_globals();
+	runner                 thread = ink->new_runner(store);
+	thread->set_rng_seed(42);
+
+	std::vector<std::unique_ptr<snapshot>> snapshots;
+	std::vector<runner>                    copies;
+	for (size_t step = 0; step < 120; ++step) {
+		if (step % 10 == 3) {
+			snapshots.emplace_back(thread->create_snapshot());
+			snapshots.emplace_back(
+			    new internal::snapshot_impl(*store.cast<internal::globals_impl>().get(), false)
+			);
+			const snapshot& compact = *snapshots[snapshots.size() - 2];
+			const snapshot& plain   = *snapshots.back();
+			REQUIRE(compact.get_data_len() < plain.get_data_len());
+
+			std::unique_ptr<snapshot> loaded{
+			    snapshot::from_binary(compact.get_data(), compact.get_data_len(), false)
+			};
+			copies.push_back(other->new_runner_from_snapshot(*loaded));
+			copies.push_back(other->new_runner_from_snapshot(plain));
+
+			for (bool old_compact : {false, true}) {
+				internal::snapshot_impl old{
+				    *store.cast<internal::globals_impl>().get(), old_compact, false
+				};
+				std::unique_ptr<snapshot> old_loaded{
+				    snapshot::from_binary(old.get_data(), old.get_data_len(), false)
+				};
+				const auto& impl = static_cast<const internal::snapshot_impl&>(*old_loaded);
+				REQUIRE_FALSE(impl.async_state());
+				REQUIRE(impl.compact() == old_compact);
+				copies.push_back(other->new_runner_from_snapshot(*old_loaded));
+			}
+		}
+		std::string expected = advance(thread, step);
+		for (runner& copy : copies) {
+			REQUIRE(advance(copy, step) == expected);
+		}
+		if (expected == "end") {
+			break;
+		}
+	}
+}
+
+SCENARIO("compact snapshots restore the same state", "[snapshot]")
+{
+	GIVEN("the test stories")
+	{
+		ink::compiler::run(INK_TEST_RESOURCE_DIR "simple-1.1.1-inklecate.json", "encoding.bin");
+		WHEN("they are restored from snapshots while playing")
+		{
+			THEN("the restored runners continue like the original")
+			{
+				compare_restored("encoding.bin");
+				for (const char* name : STORIES) {
+					compare_restored(std::string(INK_TEST_RESOURCE_DIR) + name);
+				}
+			}
+		}
+	}
+}
+
+SCENARIO("snapshot encoding cost", "[.benchmark][snapshot]")
+{
+	size_t plain_bytes = 0, compact_bytes = 0, count = 0;
+	double plain_us = 0, compact_us = 0, plain_load_us = 0, compact_load_us = 0;
+	using clock     = std::chrono::steady_clock;
+	using us        = std::chrono::duration<double, std::micro>;
+	for (const char* name : STORIES) {
+		std::string            filename = std::string(INK_TEST_RESOURCE_DIR) + name;
+		std::unique_ptr<story> ink{story::from_file(filename.c_str())};
+		globals                store  = ink->new_globals();
+		runner                 thread = ink->new_runner(store);
+		thread->set_rng_seed(42);
+		for (size_t step = 0; step < 200; ++step) {
+			if (step % 5 == 3) {
+				auto                      start = clock::now();
+				std::unique_ptr<snapshot> compact{thread->create_snapshot()};
+				auto                      mid = clock::now();
+				std::unique_ptr<snapshot> plain{
+				    new internal::snapshot_impl(*store.cast<internal::globals_impl>().get(), false)
+				};
+				auto end = clock::now();
+				compact_us += us(mid - start).count();
+				plain_us += us(end - mid).count();
+				compact_bytes += compact->get_data_len();
+				plain_bytes += plain->get_data_len();
+
+				start = clock::now();
+				ink->new_runner_from_snapshot(*compact);
+				mid = clock::now();
+				ink->new_runner_from_snapshot(*plain);
+				end = clock::now();
+				compact_load_us += us(mid - start).count();
+				plain_load_us += us(end - mid).count();
+				++count;
+			}
+			if (advance(thread, step) == "end") {
+				break;
+			}
+		}
+	}
+	WARN(
+	    count << " snapshots, plain: " << plain_bytes / count << " bytes, " << plain_us / count
+	          << " us to create, " << plain_load_us / count << " us to load; compact: "
+	          << compact_bytes / count << " bytes, " << compact_us / count << " us to create, "
+	          << compact_load_us / count << " us to load"
+	);
+}
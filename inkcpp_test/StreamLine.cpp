@@ -0,0 +1,98 @@
+#include "catch.hpp"
+
+#include <story.h>
+#include <globals.h>
+#include <runner.h>
+#include <compiler.h>
+
+using namespace ink::runtime;
+
+static constexpr const char* STORIES[] = {
+    "TheIntercept.bin",
+    "murder_scene.bin",
+    "LinesStory.bin",
+    "ListStory.bin",
+    "ListLogicStory.bin",
+    "TagsStory.bin",
+    "UTF8Story.bin",
+    "SimpleStoryFlow.bin",
+    "ChoiceBracketStory.bin",
+    "GlobalStory.bin",
+    "TempsStory.bin",
+    "NoEarlyTags.bin",
+    "FragmentsStory.bin",
+    "ThirdTierChoiceAfterBracketsStory.bin",
+    "130_131_missing_whitespace.bin",
+    "142_many_threads.bin",
+};
+
+// plays the story on two independent runners, one read with getline and one with stream_line,
+// taking the choices in turn
+static void compare_stream_line(const char* filename)
+{
+	std::unique_ptr<story> lines{story::from_file(filename)};
+	std::unique_ptr<story> spans{story::from_file(filename)};
+	runner                 by_line = lines->new_runner();
+	runner                 by_span = spans->new_runner();
+	by_line->set_rng_seed(42);
+	by_span->set_rng_seed(42);
+
+	for (size_t step = 0; step < 200; ++step) {
+		if (by_line->can_continue()) {
+			REQUIRE(by_span->can_continue());
+			std::string text;
+			by_span->stream_line([&text](const char* span, size_t length) {
+				REQUIRE(length > 0);
+				text.append(span, length);
+			});
+			REQUIRE(text == by_line->getline());
+		} else if (by_line->has_choices()) {
+			REQUIRE(by_span->num_choices() == by_line->num_choices());
+			by_line->choose(step % by_line->num_choices());
+			by_span->choose(step % by_span->num_choices());
+		} else {
+			break;
+		}
+	}
+	REQUIRE(by_span->can_continue() == by_line->can_continue());
+}
+
+SCENARIO("streaming a line gives the same text as getline", "[lines]")
+{
+	GIVEN("the test stories")
+	{
+		ink::compiler::run(INK_TEST_RESOURCE_DIR "simple-1.1.1-inklecate.json", "stream.bin");
+		WHEN("they are played with getline and with stream_line")
+		{
+			THEN("the text is the same")
+			{
+				compare_stream_line("stream.bin");
+				for (const char* name : STORIES) {
+					INFO(name);
+					compare_stream_line((std::string(INK_TEST_RESOURCE_DIR) + name).c_str());
+				}
+			}
+		}
+	}
+
+	GIVEN("a line of story text")
+	{
+		ink::compiler::run(INK_TEST_RESOURCE_DIR "simple-1.1.1-inklecate.json", "stream.bin");
+		std::unique_ptr<story> ink{story::from_file("stream.bin")};
+		runner                 thread = ink->new_runner();
+		WHEN("it is streamed")
+		{
+			size_t      count = 0;
+			std::string text;
+			thread->stream_line([&count, &text](const char* span, size_t length) {
+				++count;
+				text.append(span, length);
+			});
+			THEN("the text is passed without being copied")
+			{
+				REQUIRE(text == "Once upon a time...\n");
+				REQUIRE(count == 2);
+			}
+		}
+	}
+}
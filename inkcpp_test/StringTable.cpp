@@ -0,0 +1,124 @@
+#include "catch.hpp"
+
+#include "../inkcpp/string_table.h"
+
+#include <cstring>
+
+using ink::runtime::internal::string_table;
+
+SCENARIO("string_table allocates strings from pages", "[strings]")
+{
+	GIVEN("an empty string table")
+	{
+		string_table table;
+		REQUIRE(table.statistics().pages == 0);
+
+		WHEN("a few strings are created")
+		{
+			char* hello = table.duplicate("hello");
+			char* world = table.duplicate("world");
+
+			THEN("they share one page")
+			{
+				REQUIRE(std::strcmp(hello, "hello") == 0);
+				REQUIRE(std::strcmp(world, "world") == 0);
+				REQUIRE(world > hello);
+				auto stats = table.statistics();
+				REQUIRE(stats.pages == 1);
+				REQUIRE(stats.bytes_live == 12);
+				REQUIRE(stats.string_refs.size == 2);
+			}
+
+			WHEN("one of them is collected")
+			{
+				REQUIRE(table.created() == 2);
+				table.clear_usage();
+				table.mark_used(world);
+				REQUIRE(table.gc() == 1);
+				REQUIRE(table.created() == 0);
+
+				THEN("its bytes are wasted until the page is empty")
+				{
+					REQUIRE(std::strcmp(world, "world") == 0);
+					auto stats = table.statistics();
+					REQUIRE(stats.bytes_live == 6);
+					REQUIRE(stats.bytes_wasted > 6);
+					REQUIRE(stats.string_refs.size == 1);
+				}
+
+				WHEN("the other one is collected too")
+				{
+					table.clear_usage();
+					table.gc();
+
+					THEN("the page is reused from the start")
+					{
+						auto stats = table.statistics();
+						REQUIRE(stats.bytes_live == 0);
+						REQUIRE(stats.bytes_wasted == 0);
+						REQUIRE(table.duplicate("again") == hello);
+					}
+				}
+			}
+		}
+
+		WHEN("strings are numbered for a snapshot")
+		{
+			const char* story_string = "from the story";
+			char*       first        = table.duplicate("first");
+			char*       second       = table.duplicate("second");
+			char*       third        = table.duplicate("third");
+			table.clear_usage();
+			table.mark_used(first);
+			table.mark_used(third);
+			table.mark_used(story_string);
+			REQUIRE(table.gc() == 1);
+
+			THEN("ids follow the snapshot order of the remaining strings")
+			{
+				REQUIRE(table.get_id(first) == 0);
+				REQUIRE(table.get_id(third) == 1);
+				REQUIRE(table.statistics().string_refs.size == 2);
+				REQUIRE(second != nullptr);
+			}
+		}
+
+		WHEN("more strings are created than fit in one page")
+		{
+			const int count = ink::config::stringTablePageSize / 8;
+			char*     first = table.duplicate("1234567");
+			char*     last  = nullptr;
+			for (int i = 1; i < count; ++i) {
+				last = table.duplicate("1234567");
+			}
+			REQUIRE(table.statistics().pages == 3);
+
+			THEN("pages without used strings are freed on gc")
+			{
+				table.clear_usage();
+				table.mark_used(first);
+				table.mark_used(last);
+				table.gc();
+				auto stats = table.statistics();
+				REQUIRE(stats.pages == 2 + 1); // the emptied page is kept for reuse
+				REQUIRE(stats.string_refs.size == 2);
+				REQUIRE(stats.bytes_live == 16);
+				REQUIRE(std::strcmp(first, "1234567") == 0);
+			}
+		}
+
+		WHEN("a long string is created")
+		{
+			char*       small = table.duplicate("small");
+			std::string text(ink::config::stringTablePageSize, 'x');
+			char*       large = table.duplicate(text.c_str());
+
+			THEN("it gets a page on its own")
+			{
+				REQUIRE(text == large);
+				REQUIRE(table.statistics().pages == 2);
+				REQUIRE(table.duplicate("next") > small);
+			}
+		}
+	}
+}
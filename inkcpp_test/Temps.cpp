@@ -0,0 +1,48 @@
+#include "catch.hpp"
+
+#include <chrono>
+#include <compiler.h>
+#include <globals.h>
+#include <runner.h>
+#include <story.h>
+
+using namespace ink::runtime;
+
+SCENARIO("a function with many temporary variables", "[variables]")
+{
+	GIVEN("a story calling a function with eight temporaries in a loop")
+	{
+		std::unique_ptr<story> ink{story::from_file(INK_TEST_RESOURCE_DIR "TempsStory.bin")};
+		runner                 thread = ink->new_runner();
+
+		WHEN("run")
+		{
+			std::string line = thread->getline();
+			THEN("every temporary resolves to the right value")
+			{
+				REQUIRE(line == "Total 6535506\n");
+				REQUIRE_FALSE(thread->can_continue());
+			}
+		}
+	}
+}
+
+SCENARIO("temporary variable access throughput", "[.benchmark][variables]")
+{
+	std::unique_ptr<story> ink{story::from_file(INK_TEST_RESOURCE_DIR "TempsStory.bin")};
+
+	constexpr int runs  = 100;
+	size_t        lines = 0;
+	auto          start = std::chrono::steady_clock::now();
+	for (int i = 0; i < runs; ++i) {
+		runner thread = ink->new_runner();
+		lines += thread->getline() == "Total 6535506\n";
+	}
+	std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+	WARN(
+	    "1000 calls with 8 temporaries x " << runs << " runs in " << seconds.count() << "s = "
+	                                       << seconds.count() / runs * 1000 << "ms per run"
+	);
+	REQUIRE(lines == runs);
+}
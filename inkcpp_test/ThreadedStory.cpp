@@ -0,0 +1,79 @@
+#include "catch.hpp"
+
+#include <story.h>
+#include <globals.h>
+#include <runner.h>
+#include <compiler.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ink::runtime;
+
+// plays the story to the end, taking the choices in turn, and returns everything that happened
+static std::string play(runner thread)
+{
+	std::string transcript;
+	for (size_t step = 0; step < 200; ++step) {
+		if (thread->can_continue()) {
+			transcript += thread->getline();
+		} else if (thread->has_choices()) {
+			size_t index = step % thread->num_choices();
+			transcript += "> " + std::to_string(index) + "\n";
+			// copies of the pointer live and die on every thread
+			runner copy = thread;
+			copy->choose(index);
+		} else {
+			break;
+		}
+	}
+	return transcript;
+}
+
+SCENARIO("runners of one story run on different threads", "[story][threads]")
+{
+	constexpr size_t thread_count = 8;
+	constexpr size_t rounds       = 25;
+
+	GIVEN("a story shared by all threads")
+	{
+		ink::compiler::run(INK_TEST_RESOURCE_DIR "simple-1.1.1-inklecate.json", "threads.bin");
+		std::unique_ptr<story> ink{story::from_file("threads.bin")};
+		const std::string      expected = play(ink->new_runner());
+
+		WHEN("every thread plays with its own runners and globals")
+		{
+			// the runners are created here and handed to the threads, so the first reference of each
+			// is dropped while the threads already run
+			std::vector<runner> runners;
+			for (size_t i = 0; i < thread_count; ++i) {
+				runners.push_back(ink->new_runner(ink->new_globals()));
+			}
+
+			std::vector<std::string> transcripts(thread_count * rounds);
+			std::vector<std::thread> threads;
+			for (size_t i = 0; i < thread_count; ++i) {
+				threads.emplace_back([&ink, &transcripts, i, first = runners[i]]() {
+					transcripts[i * rounds] = play(first);
+					for (size_t round = 1; round < rounds; ++round) {
+						runner thread = round % 2 ? ink->acquire_runner() : ink->new_runner();
+						transcripts[i * rounds + round] = play(thread);
+						ink->release_runner(thread);
+					}
+				});
+			}
+			runners.clear();
+			for (std::thread& thread : threads) {
+				thread.join();
+			}
+
+			THEN("they all play the story like a single runner")
+			{
+				for (const std::string& transcript : transcripts) {
+					REQUIRE(transcript == expected);
+				}
+			}
+		}
+	}
+}
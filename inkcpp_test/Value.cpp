@@ -1,5 +1,6 @@
 #include "catch.hpp"
 
+#include <chrono>
 #include <compiler.h>
 #include <story.h>
 
@@ -213,3 +214,64 @@ SCENARIO("compare concatenated values")
 		}
 	}
 }
+
+SCENARIO("operation dispatch throughput", "[.benchmark][dispatch]")
+{
+	prng          rng;
+	eval_stack    stack;
+	story_impl    story(INK_TEST_RESOURCE_DIR "ListStory.bin");
+	globals       globs_ptr = story.new_globals();
+	runner        run       = story.new_runner(globs_ptr);
+	globals_impl& globs     = *globs_ptr.cast<globals_impl>();
+	executer      ops(rng, story, globs, globs.strings(), globs.lists(), *run);
+	const value   lst = *globs.get_variable(ink::hash_string("list"));
+
+	constexpr int runs = 1000000;
+	auto          measure = [&](const char* name, auto push, Command cmd) {
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < runs; ++i) {
+			push();
+			ops(cmd, stack);
+			stack.pop();
+		}
+		std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - start;
+		WARN(name << ": " << ns.count() / runs << " ns/op");
+		REQUIRE(stack.is_empty());
+	};
+
+	measure(
+	    "ADD int",
+	    [&]() {
+		    stack.push(value{}.set<value_type::int32>(1));
+		    stack.push(value{}.set<value_type::int32>(2));
+	    },
+	    Command::ADD
+	);
+	measure(
+	    "MAX float",
+	    [&]() {
+		    stack.push(value{}.set<value_type::float32>(1.f));
+		    stack.push(value{}.set<value_type::int32>(2));
+	    },
+	    Command::MAX
+	);
+	measure("NOT", [&]() { stack.push(value{}.set<value_type::int32>(1)); }, Command::NOT);
+	measure(
+	    "IS_EQUAL string",
+	    [&]() {
+		    stack.push(value{}.set<value_type::string>("ab"));
+		    stack.push(value{}.set<value_type::string>("ab"));
+	    },
+	    Command::IS_EQUAL
+	);
+	measure("LIST_COUNT", [&]() { stack.push(lst); }, Command::LIST_COUNT);
+	measure(
+	    "HAS",
+	    [&]() {
+		    stack.push(lst);
+		    stack.push(lst);
+	    },
+	    Command::HAS
+	);
+	measure("LIST_MIN", [&]() { stack.push(lst); }, Command::LIST_MIN);
+}
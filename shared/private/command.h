@@ -123,9 +123,42 @@ enum class Command : uint8_t {
 	// == Function calls
 	CALL_EXTERNAL,
 
+	// == Fused instructions
+	// Replace the first command of a common sequence, the remaining commands of the sequence stay
+	// in place (so jumps into the sequence still work) and are skipped. See unfused()
+	EVAL_STR, // START_EVAL STR END_EVAL
+	FUSED_BEGIN = EVAL_STR,
+	EVAL_VARIABLE_OP_INT, // START_EVAL PUSH_VARIABLE_VALUE INT <binary operator> END_EVAL
+	TAG_STR,              // START_TAG STR END_TAG
+	STR_NEWLINE,          // STR NEWLINE
+
 	NUM_COMMANDS,
 };
 
+// Command replaced by a fused command, or the command itself if it is not fused
+constexpr Command unfused(Command cmd)
+{
+	switch (cmd) {
+		case Command::EVAL_STR:
+		case Command::EVAL_VARIABLE_OP_INT: return Command::START_EVAL;
+		case Command::TAG_STR: return Command::START_TAG;
+		case Command::STR_NEWLINE: return Command::STR;
+		default: return cmd;
+	}
+}
+
+// Number of instructions covered by a fused command, 1 if it is not fused
+constexpr int fused_length(Command cmd)
+{
+	switch (cmd) {
+		case Command::EVAL_STR: return 3;
+		case Command::EVAL_VARIABLE_OP_INT: return 5;
+		case Command::TAG_STR: return 3;
+		case Command::STR_NEWLINE: return 2;
+		default: return 1;
+	}
+}
+
 extern const char* CommandStrings[];
 
 inline std::ostream& operator<<(std::ostream& out, Command cmd)
@@ -161,6 +194,11 @@ enum class CommandFlag : uint8_t {
 	// == Variable assignment
 	ASSIGNMENT_IS_REDEFINE = 1 << 0,
 
+	// == Newline flags
+	// Newline is always followed by more text, without glue, tags or choices in between. The line
+	// ends here, no need to look ahead.
+	NEWLINE_ENDS_LINE = 1 << 0,
+
 	// == Function/Tunnel flags
 	FUNCTION_TO_VARIABLE = 1 << 0,
 	TUNNEL_TO_VARIABLE   = 1 << 0,
@@ -198,6 +236,7 @@ inline std::ostream& operator<<(std::ostream& out, CommandFlag cmd)
 	CHECK_FLAG(CONTAINER_MARKER_TRACK_TURNS);
 	CHECK_FLAG(CONTAINER_MARKER_ONLY_FIRST);
 	CHECK_FLAG(ASSIGNMENT_IS_REDEFINE);
+	CHECK_FLAG(NEWLINE_ENDS_LINE);
 	CHECK_FLAG(FUNCTION_TO_VARIABLE);
 	CHECK_FLAG(TUNNEL_TO_VARIABLE);
 	CHECK_FLAG(FALLBACK_FUNCTION);
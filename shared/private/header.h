@@ -17,6 +17,10 @@ struct header {
 	static constexpr uint32_t InkBinMagic        = ('I' << 24) | ('N' << 16) | ('K' << 8) | 'B';
 	static constexpr uint32_t InkBinMagic_Differ = ('B' << 24) | ('K' << 16) | ('N' << 8) | 'I';
 	static constexpr uint32_t Alignment          = 16;
+	// First ink.bin version which may contain fused instructions (see Command::FUSED_BEGIN).
+	static constexpr uint16_t FusedVersion       = 3;
+	// First ink.bin version which stores the story hash in the header (see _hash)
+	static constexpr uint16_t HashVersion        = 4;
 
 	uint32_t ink_bin_magic          = InkBinMagic;
 	uint16_t ink_version_number     = 0;
@@ -59,6 +63,35 @@ struct header {
 	section_t _container_map;
 	section_t _container_hash;
 	section_t _instructions;
+
+	// hash_data() of the file from the first section to the end of the instructions.
+	// Only set since HashVersion, older files have other data at this position.
+	// Use hash() to read it in native byte order.
+	hash_t _hash = 0;
+
+	// ink.bin version in native byte order
+	uint16_t bin_version() const { return native(ink_bin_version_number); }
+
+	// Checks if the story hash is stored in the header
+	bool has_hash() const { return bin_version() >= HashVersion; }
+
+	// Story hash in native byte order, see _hash
+	hash_t hash() const { return native(_hash); }
+
+private:
+	// swaps the byte order of value if the file was written with a different endian-ness
+	template<typename T>
+	T native(T value) const
+	{
+		if (endian() != endian_types::differ) {
+			return value;
+		}
+		T result = 0;
+		for (size_t i = 0; i < sizeof(T); ++i) {
+			result = static_cast<T>((result << 8) | ((value >> (i * 8)) & 0xFF));
+		}
+		return result;
+	}
 };
 
 // One entry in the container hash. Used to translate paths into story locations.
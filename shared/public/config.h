@@ -30,6 +30,27 @@
 #	define INK_ENABLE_EXCEPTIONS
 #endif
 
+// Instruction dispatch of the runner. Threaded dispatch executes runs of instructions
+// without returning to the line handling, using computed goto where the compiler supports it.
+// Define INKCPP_SWITCH_DISPATCH to step every instruction through a plain switch instead.
+#ifndef INKCPP_SWITCH_DISPATCH
+#	define INK_ENABLE_THREADED_DISPATCH
+#	if defined(__GNUC__) || defined(__clang__)
+#		define INK_ENABLE_COMPUTED_GOTO
+#	endif
+#endif
+
+// Memory mapped story loading (story::from_mmap), needs an OS which provides file mappings
+#if defined(INK_ENABLE_CSTD) && (defined(__unix__) || defined(__APPLE__) || defined(_WIN32))
+#	define INK_ENABLE_MMAP
+#endif
+
+// Objects of one story may be used on different threads: story_ptr reference counts are atomic
+// and the runner pool is locked. Define INKCPP_NO_THREADS for single threaded hosts.
+#if defined(INK_ENABLE_CSTD) && ! defined(INKCPP_NO_THREADS)
+#	define INK_ENABLE_THREADS
+#endif
+
 // Only turn on if you have json.hpp and you want to use it with the compiler
 // #define INK_EXPOSE_JSON
 
@@ -59,6 +80,14 @@ static constexpr int limitReferenceStack = -20;
 static constexpr int limitOutputSize     = -100;
 // maximum number of text fragments between choices
 static constexpr int limitStringTable    = -100;
+// bytes per page of the string table, longer strings get a page on their own
+static constexpr int stringTablePageSize = 4096;
+/// number of strings and lists created since the last garbage collection, before the next one
+/// runs at the end of a line. 0 collects after every line. A collection also runs if the string or
+/// list table would need to grow.
+static constexpr int gcAllocationThreshold = 32;
+// released runners kept by a story for reuse, see story::acquire_runner
+static constexpr int limitRunnerPool     = 8;
 // max number of choices per choice
 static constexpr int maxChoices          = -10;
 // max number of list types, and there total amount of flags
@@ -68,6 +97,13 @@ static constexpr int maxFlags            = -200;
 static constexpr int maxLists            = -50;
 // max number of arguments for external functions (dynamic not possible)
 static constexpr int maxArrayCallArity   = 10;
+/// decode the instructions on story load into an aligned form with resolved operands
+/// (strings, jump targets and containers), see @ref statistics::story::decoded_instructions
+static constexpr bool predecodeInstructions = true;
+/// let the compiler fuse common instruction sequences into a single instruction. Fused
+/// instructions need a runtime which reads at least ink.bin version header::FusedVersion, stories
+/// are always written with the current InkBinVersion
+static constexpr bool fuseInstructions = true;
 
 namespace statistics
 {
@@ -84,7 +120,18 @@ namespace statistics
 	};
 
 	struct string_table {
-		container string_refs; /** based on @ref limitStringTable */
+		container string_refs;  /** based on @ref limitStringTable */
+		int       pages;        /** pages allocated, see @ref stringTablePageSize */
+		int       bytes_live;   /** bytes used by strings still in the table */
+		int       bytes_wasted; /** bytes of collected strings and string headers, freed with their page */
+	};
+
+	struct gc {
+		int collections;   /** garbage collections run */
+		int skipped;       /** lines ended without collection, see @ref gcAllocationThreshold */
+		int strings_freed; /** strings deleted by all collections */
+		int lists_freed;   /** lists deleted by all collections */
+		int time_us;       /** time spent collecting in microseconds (only with STL) */
 	};
 
 	struct global {
@@ -92,6 +139,7 @@ namespace statistics
 		container    variables_observers; /** based on @ref limitGlobalVariableObservers */
 		list_table   lists;
 		string_table strings;
+		gc           garbage_collection;
 	};
 
 	struct runner {
@@ -104,5 +152,10 @@ namespace statistics
 		container output;            /** based on @ref limitOutputSize */
 		container choices;           /** based on @ref limitContainerDepth */
 	};
+
+	struct story {
+		int instructions;         /** number of instructions in the story */
+		int decoded_instructions; /** bytes used by decoded instructions @ref predecodeInstructions */
+	};
 } // namespace statistics
 } // namespace ink::config
@@ -135,7 +135,21 @@ inline hash_t hash_string(const char* string)
 }
 #else
 hash_t hash_string(const char* string);
+
+/** Hash of binary data, used to identify stories.
+ *
+ * The hash is stored in ink.bin files and snapshots, so its result must not change.
+ * The data is read in 8 byte words in native byte order, like all ink.bin data. The last
+ * incomplete word is padded with zeros and the length is mixed into the seed.
+ */
 hash_t hash_data(const unsigned char* data, size_t len);
+
+/** Byte wise hash of binary data, used as story hash before ink.bin version 4.
+ *
+ * Stories loaded from older files keep this hash, so snapshots taken with earlier versions still
+ * belong to them.
+ */
+hash_t hash_data_legacy(const unsigned char* data, size_t len);
 #endif
 
 namespace internal
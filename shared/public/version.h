@@ -9,6 +9,7 @@
 #include "system.h"
 
 namespace ink {
-constexpr uint32_t InkBinVersion = 2;  ///< Supportet version of ink.bin files
-constexpr uint32_t InkVersion    = 21; ///< Supported version of ink.json files
+constexpr uint32_t InkBinVersion    = 4;  ///< Supportet version of ink.bin files
+constexpr uint32_t InkBinVersionMin = 2;  ///< Oldest ink.bin version which can still be loaded
+constexpr uint32_t InkVersion       = 21; ///< Supported version of ink.json files
 };